@@ -5,10 +5,12 @@ emcc src/*.cpp -o web-build/index.html \
   libraylib.web.a \
   -DPLATFORM_WEB \
   -DEMSCRIPTEN_BUILD \
+  -DHOVERCAT_FRAME_STATS \
   -s USE_GLFW=3 \
   -s ASYNCIFY \
   -s TOTAL_MEMORY=16777216 \
   -s FORCE_FILESYSTEM=1 \
+  -lidbfs.js \
   -s EXPORTED_FUNCTIONS="['_main']" \
   -s EXPORTED_RUNTIME_METHODS="['ccall', 'cwrap']" \
   -s ALLOW_MEMORY_GROWTH=1 \
@@ -19,6 +21,7 @@ emcc src/*.cpp -o web-build/index.html \
 
 # Check if the emcc build was successful
 if [ $? -eq 0 ]; then
+  cmake -DWEB_DIR=web-build -P cmake/SizeReport.cmake
   echo "Build succeeded, creating web-build.zip..."
   powershell -Command "Compress-Archive -Path web-build\* -DestinationPath web-build.zip -Force"
   cd web-build
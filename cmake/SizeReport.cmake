@@ -0,0 +1,38 @@
+# Usage: cmake -DWEB_DIR=<dir> [-DBASELINE_WEB_DIR=<dir>] -P SizeReport.cmake
+# Prints the raw and gzip-compressed sizes of index.wasm, index.js and
+# index.data in each directory, and their combined gzip size (what a browser
+# actually downloads from itch.io / a static host).
+
+cmake_minimum_required(VERSION 3.18)
+
+function(report_web label dir)
+    if(NOT EXISTS "${dir}/index.wasm")
+        message(STATUS "${label}: ${dir}/index.wasm not found, skipping")
+        return()
+    endif()
+    set(total_gz 0)
+    foreach(name index.wasm index.js index.data)
+        set(path "${dir}/${name}")
+        if(NOT EXISTS "${path}")
+            message(STATUS "${label}: ${name} not found")
+            continue()
+        endif()
+        file(SIZE "${path}" raw_size)
+        # Each file is fetched and compressed on its own, so gzip them separately
+        set(gz_path "${CMAKE_CURRENT_BINARY_DIR}/${label}_${name}.gz")
+        file(ARCHIVE_CREATE OUTPUT "${gz_path}" PATHS "${path}" FORMAT raw COMPRESSION GZip)
+        file(SIZE "${gz_path}" gz_size)
+        file(REMOVE "${gz_path}")
+        math(EXPR total_gz "${total_gz} + ${gz_size}")
+        math(EXPR raw_kb "${raw_size} / 1024")
+        math(EXPR gz_kb "${gz_size} / 1024")
+        message(STATUS "${label}: ${name} ${raw_kb} KiB, gzip ${gz_kb} KiB")
+    endforeach()
+    math(EXPR total_kb "${total_gz} / 1024")
+    message(STATUS "${label}: download (gzip, wasm + js + data) ${total_kb} KiB")
+endfunction()
+
+report_web("cmake" "${WEB_DIR}")
+if(BASELINE_WEB_DIR)
+    report_web("build_web.sh" "${BASELINE_WEB_DIR}")
+endif()
@@ -0,0 +1,311 @@
+#include <cmath>
+#include <utility>
+#include <chrono>
+
+#include "analytics.h"
+
+void AnalyticsBlock::Clear()
+{
+    type.clear();
+    player.clear();
+    run.clear();
+    tick.clear();
+    score.clear();
+    x.clear();
+    y.clear();
+    velocity.clear();
+    pipeSpeed.clear();
+    gapDelta.clear();
+    outcome.clear();
+}
+
+void AnalyticsBlock::Reserve(size_t count)
+{
+    type.reserve(count);
+    player.reserve(count);
+    run.reserve(count);
+    tick.reserve(count);
+    score.reserve(count);
+    x.reserve(count);
+    y.reserve(count);
+    velocity.reserve(count);
+    pipeSpeed.reserve(count);
+    gapDelta.reserve(count);
+    outcome.reserve(count);
+}
+
+static int32_t ToFixed(float value)
+{
+    return (int32_t)lroundf(value * analyticsFixedScale);
+}
+
+static float FromFixed(int32_t value)
+{
+    return value / analyticsFixedScale;
+}
+
+void AnalyticsBlock::Push(const AnalyticsEvent& event)
+{
+    type.push_back(event.type);
+    player.push_back(event.player);
+    run.push_back(event.run);
+    tick.push_back(event.tick);
+    score.push_back(event.score);
+    x.push_back(ToFixed(event.x));
+    y.push_back(ToFixed(event.y));
+    velocity.push_back(ToFixed(event.velocity));
+    pipeSpeed.push_back(ToFixed(event.pipeSpeed));
+    gapDelta.push_back(ToFixed(event.gapDelta));
+    outcome.push_back(event.outcome);
+}
+
+AnalyticsEvent AnalyticsBlock::Get(size_t index) const
+{
+    AnalyticsEvent event;
+    event.type = type[index];
+    event.player = player[index];
+    event.run = run[index];
+    event.tick = tick[index];
+    event.score = score[index];
+    event.x = FromFixed(x[index]);
+    event.y = FromFixed(y[index]);
+    event.velocity = FromFixed(velocity[index]);
+    event.pipeSpeed = FromFixed(pipeSpeed[index]);
+    event.gapDelta = FromFixed(gapDelta[index]);
+    event.outcome = outcome[index];
+    return event;
+}
+
+// Little-endian fixed-width helpers for the block header
+template <typename T>
+static void PutFixed(std::vector<uint8_t>& out, T value)
+{
+    for (size_t i = 0; i < sizeof(T); i++) {
+        out.push_back((uint8_t)((uint64_t)value >> (8 * i)));
+    }
+}
+
+template <typename T>
+static bool GetFixed(std::istream& in, T& value)
+{
+    uint8_t bytes[sizeof(T)];
+    if (!in.read((char*)bytes, sizeof(T))) return false;
+    uint64_t result = 0;
+    for (size_t i = 0; i < sizeof(T); i++) {
+        result |= (uint64_t)bytes[i] << (8 * i);
+    }
+    value = (T)result;
+    return true;
+}
+
+// Columns are stored as deltas from the previous row, zigzag mapped so small
+// negative deltas stay small, then varint encoded
+template <typename T>
+static void EncodeColumn(const std::vector<T>& column, std::vector<uint8_t>& out)
+{
+    std::vector<uint8_t> bytes;
+    bytes.reserve(column.size() * 2);
+    int64_t previous = 0;
+    for (T value : column) {
+        int64_t delta = (int64_t)value - previous;
+        previous = (int64_t)value;
+        uint64_t zigzag = ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+        while (zigzag >= 0x80) {
+            bytes.push_back((uint8_t)(zigzag | 0x80));
+            zigzag >>= 7;
+        }
+        bytes.push_back((uint8_t)zigzag);
+    }
+    PutFixed<uint32_t>(out, (uint32_t)bytes.size());
+    out.insert(out.end(), bytes.begin(), bytes.end());
+}
+
+template <typename T>
+static bool DecodeColumn(std::istream& in, uint32_t count, std::vector<T>& column, std::vector<uint8_t>& scratch)
+{
+    uint32_t length;
+    if (!GetFixed(in, length)) return false;
+    scratch.resize(length);
+    if (length > 0 && !in.read((char*)scratch.data(), length)) return false;
+
+    column.resize(count);
+    size_t pos = 0;
+    int64_t previous = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint64_t zigzag = 0;
+        int shift = 0;
+        while (true) {
+            if (pos >= length || shift > 63) return false;
+            uint8_t byte = scratch[pos++];
+            zigzag |= (uint64_t)(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) break;
+            shift += 7;
+        }
+        int64_t delta = (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+        previous += delta;
+        column[i] = (T)previous;
+    }
+    return pos == length;
+}
+
+void EncodeAnalyticsBlock(const AnalyticsBlock& block, std::vector<uint8_t>& out)
+{
+    out.clear();
+    PutFixed<uint32_t>(out, analyticsBlockMagic);
+    PutFixed<uint16_t>(out, analyticsFormatVersion);
+    PutFixed<uint16_t>(out, (uint16_t)block.buildId.size());
+    out.insert(out.end(), block.buildId.begin(), block.buildId.end());
+    PutFixed<uint64_t>(out, block.sessionId);
+    PutFixed<uint32_t>(out, (uint32_t)block.Size());
+    EncodeColumn(block.type, out);
+    EncodeColumn(block.player, out);
+    EncodeColumn(block.run, out);
+    EncodeColumn(block.tick, out);
+    EncodeColumn(block.score, out);
+    EncodeColumn(block.x, out);
+    EncodeColumn(block.y, out);
+    EncodeColumn(block.velocity, out);
+    EncodeColumn(block.pipeSpeed, out);
+    EncodeColumn(block.gapDelta, out);
+    EncodeColumn(block.outcome, out);
+}
+
+bool ReadAnalyticsBlock(std::istream& in, AnalyticsBlock& block)
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t buildIdLength;
+    uint32_t count;
+    if (!GetFixed(in, magic) || magic != analyticsBlockMagic) return false;
+    // Version 1 logs predate races; all their events belong to player 0
+    if (!GetFixed(in, version) || version < 1 || version > analyticsFormatVersion) return false;
+    block.version = version;
+    if (!GetFixed(in, buildIdLength)) return false;
+    block.buildId.resize(buildIdLength);
+    if (buildIdLength > 0 && !in.read(&block.buildId[0], buildIdLength)) return false;
+    if (!GetFixed(in, block.sessionId) || !GetFixed(in, count)) return false;
+
+    std::vector<uint8_t> scratch;
+    if (!DecodeColumn(in, count, block.type, scratch)) return false;
+    if (version >= 2) {
+        if (!DecodeColumn(in, count, block.player, scratch)) return false;
+    } else {
+        block.player.assign(count, 0);
+    }
+    if (!DecodeColumn(in, count, block.run, scratch)
+        || !DecodeColumn(in, count, block.tick, scratch)
+        || !DecodeColumn(in, count, block.score, scratch)
+        || !DecodeColumn(in, count, block.x, scratch)
+        || !DecodeColumn(in, count, block.y, scratch)
+        || !DecodeColumn(in, count, block.velocity, scratch)
+        || !DecodeColumn(in, count, block.pipeSpeed, scratch)
+        || !DecodeColumn(in, count, block.gapDelta, scratch)) return false;
+    // Logs before version 3 have no ANALYTICS_RUN_END events
+    if (version >= 3) return DecodeColumn(in, count, block.outcome, scratch);
+    block.outcome.assign(count, ANALYTICS_OUTCOME_NONE);
+    return true;
+}
+
+AnalyticsLog::AnalyticsLog()
+{
+    enabled = false;
+#ifndef __EMSCRIPTEN__
+    stopWorker = false;
+#endif
+}
+
+AnalyticsLog::~AnalyticsLog()
+{
+    Flush();
+#ifndef __EMSCRIPTEN__
+    if (worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopWorker = true;
+        }
+        queueCondition.notify_one();
+        worker.join();
+    }
+#endif
+}
+
+void AnalyticsLog::Open(const std::string& path, const std::string& buildId)
+{
+#ifndef __EMSCRIPTEN__
+    // Web builds have no persistent file system to log to
+    this->path = path;
+    current.buildId = buildId;
+    current.sessionId = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    current.Reserve(blockCapacity);
+    freeBlocks.resize(2);
+    for (auto& block : freeBlocks) {
+        block.Reserve(blockCapacity);
+    }
+    enabled = true;
+    worker = std::thread(&AnalyticsLog::WorkerLoop, this);
+#else
+    (void)path;
+    (void)buildId;
+#endif
+}
+
+void AnalyticsLog::Record(const AnalyticsEvent& event)
+{
+    if (!enabled) return;
+    current.Push(event);
+    if (current.Size() >= blockCapacity) {
+        Flush();
+    }
+}
+
+void AnalyticsLog::Flush()
+{
+#ifndef __EMSCRIPTEN__
+    if (!enabled || current.Size() == 0) return;
+
+    AnalyticsBlock next;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (!freeBlocks.empty()) {
+            next = std::move(freeBlocks.back());
+            freeBlocks.pop_back();
+        }
+        next.buildId = current.buildId;
+        next.sessionId = current.sessionId;
+        pending.push_back(std::move(current));
+    }
+    queueCondition.notify_one();
+    current = std::move(next);
+    current.Clear();
+#endif
+}
+
+void AnalyticsLog::WriteBlock(const AnalyticsBlock& block)
+{
+    std::vector<uint8_t> bytes;
+    EncodeAnalyticsBlock(block, bytes);
+    std::ofstream file(path, std::ios::binary | std::ios::app);
+    if (file.is_open()) {
+        file.write((const char*)bytes.data(), bytes.size());
+    }
+}
+
+#ifndef __EMSCRIPTEN__
+void AnalyticsLog::WorkerLoop()
+{
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (true) {
+        queueCondition.wait(lock, [this] { return stopWorker || !pending.empty(); });
+        if (pending.empty()) break;
+
+        AnalyticsBlock block = std::move(pending.front());
+        pending.pop_front();
+        lock.unlock();
+        WriteBlock(block);
+        block.Clear();
+        lock.lock();
+        freeBlocks.push_back(std::move(block));
+    }
+}
+#endif
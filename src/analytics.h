@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <fstream>
+#ifndef __EMSCRIPTEN__
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+// Gameplay analytics: events are buffered in a fixed-size columnar block and
+// appended to a binary file by a worker thread. Each column is delta + zigzag
+// + varint encoded, so ticks, positions and speeds pack into a few bytes each.
+// Nothing in here depends on raylib so tools/ can link it for offline queries.
+
+enum AnalyticsEventType : uint8_t {
+    ANALYTICS_RUN_START = 0,
+    ANALYTICS_FLAP,
+    ANALYTICS_SCORE,
+    ANALYTICS_DEATH,
+    ANALYTICS_PAUSE,
+    ANALYTICS_RESUME,
+    ANALYTICS_RUN_END,    // Logged once per run, by its best cat, with the outcome
+    ANALYTICS_EVENT_COUNT
+};
+
+enum AnalyticsRunOutcome : uint8_t {
+    ANALYTICS_OUTCOME_NONE = 0,        // Every event but ANALYTICS_RUN_END
+    ANALYTICS_OUTCOME_DEATH,
+    ANALYTICS_OUTCOME_COURSE_COMPLETE
+};
+
+struct AnalyticsEvent {
+    uint8_t type;
+    uint8_t player;      // Cat the event belongs to, 0 outside races
+    uint32_t run;        // Run number within the session
+    uint32_t tick;       // Simulation frame within the run
+    int32_t score;       // Pipes this cat passed, i.e. index of its next pipe
+    float x;
+    float y;
+    float velocity;
+    float pipeSpeed;
+    float gapDelta;      // Player y minus the gap center of the next pipe
+    uint8_t outcome;     // AnalyticsRunOutcome
+};
+
+// One flushed block of events stored column by column
+struct AnalyticsBlock {
+    std::string buildId;
+    uint64_t sessionId = 0;
+    uint16_t version = 0;            // Format version the block was read from
+    std::vector<uint8_t> type;
+    std::vector<uint8_t> player;
+    std::vector<uint32_t> run;
+    std::vector<uint32_t> tick;
+    std::vector<int32_t> score;
+    std::vector<int32_t> x;          // Fixed point, see analyticsFixedScale
+    std::vector<int32_t> y;
+    std::vector<int32_t> velocity;
+    std::vector<int32_t> pipeSpeed;
+    std::vector<int32_t> gapDelta;
+    std::vector<uint8_t> outcome;
+
+    size_t Size() const { return type.size(); }
+    void Clear();
+    void Reserve(size_t count);
+    void Push(const AnalyticsEvent& event);
+    AnalyticsEvent Get(size_t index) const;
+};
+
+const float analyticsFixedScale = 10.0f;  // Floats are stored in 0.1 units
+const uint32_t analyticsBlockMagic = 0x54414348;  // "HCAT"
+const uint16_t analyticsFormatVersion = 3;  // 2 added the player column, 3 the outcome column
+
+void EncodeAnalyticsBlock(const AnalyticsBlock& block, std::vector<uint8_t>& out);
+// Reads the next block from the stream, returns false at end of file or on a corrupt block
+bool ReadAnalyticsBlock(std::istream& in, AnalyticsBlock& block);
+
+class AnalyticsLog
+{
+public:
+    AnalyticsLog();
+    ~AnalyticsLog();
+    void Open(const std::string& path, const std::string& buildId);
+    void Record(const AnalyticsEvent& event);
+    void Flush();
+
+private:
+    void WriteBlock(const AnalyticsBlock& block);
+
+    static const size_t blockCapacity = 4096;
+
+    std::string path;
+    bool enabled;
+    AnalyticsBlock current;
+
+#ifndef __EMSCRIPTEN__
+    void WorkerLoop();
+
+    std::thread worker;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::deque<AnalyticsBlock> pending;
+    std::vector<AnalyticsBlock> freeBlocks;  // Recycled so recording never allocates
+    bool stopWorker;
+#endif
+};
@@ -0,0 +1,331 @@
+#include <cstring>
+#include <algorithm>
+
+#include "globals.h"
+#include "capture.h"
+
+#ifndef __EMSCRIPTEN__
+#include "rlgl.h"
+#include "external/glad.h"  // raylib's GL loader, already initialized by InitWindow
+#endif
+
+FrameCapture::FrameCapture()
+{
+    active = false;
+    width = 0;
+    height = 0;
+    fps = 0;
+    captureClock = 0.0;
+    framesDue = 0;
+    carryRepeat = 0;
+    frameBytes = 0;
+    frameIndex = 0;
+    for (int i = 0; i < pboCount; i++) {
+        pbo[i] = 0;
+        slotRun[i] = 0;
+        slotTick[i] = 0;
+        slotRepeat[i] = 0;
+        slotFilled[i] = false;
+    }
+    captureTime = 0.0;
+    captureMax = 0.0;
+    frameIntervalSum = 0.0;
+    lastFrameTime = 0.0;
+    statFrames = 0;
+    statTimer = 0.0;
+    framesWritten = 0;
+    framesDropped = 0;
+    encodeTime = 0.0;
+    framesEncoded = 0;
+#ifndef __EMSCRIPTEN__
+    file = nullptr;
+    stopWorker = false;
+#endif
+}
+
+FrameCapture::~FrameCapture()
+{
+    Stop();
+}
+
+bool FrameCapture::Start(const std::string& path, int width, int height, int fps)
+{
+#ifndef __EMSCRIPTEN__
+    Stop();
+
+    file = fopen(path.c_str(), "wb");
+    if (!file) {
+        TraceLog(LOG_WARNING, "CAPTURE: cannot open %s", path.c_str());
+        return false;
+    }
+    fprintf(file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, fps);
+
+    this->path = path;
+    this->width = width;
+    this->height = height;
+    this->fps = fps;
+    captureClock = 0.0;
+    framesDue = 0;
+    carryRepeat = 0;
+    frameBytes = (size_t)width * height * 4;
+
+    glGenBuffers(pboCount, pbo);
+    for (int i = 0; i < pboCount; i++) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)frameBytes, nullptr, GL_STREAM_READ);
+        slotFilled[i] = false;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    freeFrames.resize(maxQueuedFrames);
+    for (CapturedFrame& frame : freeFrames) {
+        frame.rgba.resize(frameBytes);
+    }
+
+    frameIndex = 0;
+    captureTime = 0.0;
+    captureMax = 0.0;
+    frameIntervalSum = 0.0;
+    lastFrameTime = 0.0;
+    statFrames = 0;
+    statTimer = GetTime();
+    framesWritten = 0;
+    framesDropped = 0;
+    encodeTime = 0.0;
+    framesEncoded = 0;
+    stopWorker = false;
+    worker = std::thread(&FrameCapture::WorkerLoop, this);
+    active = true;
+    TraceLog(LOG_INFO, "CAPTURE: recording %dx%d to %s", width, height, path.c_str());
+    return true;
+#else
+    (void)path; (void)width; (void)height; (void)fps;
+    TraceLog(LOG_WARNING, "CAPTURE: not available in web builds");
+    return false;
+#endif
+}
+
+void FrameCapture::Stop()
+{
+#ifndef __EMSCRIPTEN__
+    if (!active) return;
+
+    // Collect the readbacks still in flight, oldest first
+    for (int i = 1; i <= pboCount; i++) {
+        CollectSlot((int)((frameIndex + i) % pboCount));
+    }
+    glDeleteBuffers(pboCount, pbo);
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopWorker = true;
+    }
+    queueCondition.notify_one();
+    worker.join();
+    fclose(file);
+    file = nullptr;
+    active = false;
+
+    LogStats(true);
+    pending.clear();
+    freeFrames.clear();
+#endif
+}
+
+void FrameCapture::CaptureFrame(const RenderTexture2D& target, float dt, unsigned int run, unsigned int tick)
+{
+#ifndef __EMSCRIPTEN__
+    if (!active) return;
+    double start = GetTime();
+
+    // Output frame k shows the game at time k / fps; this frame stands for
+    // every output frame up to the current game time that is not issued yet
+    captureClock += dt;
+    uint64_t due = (uint64_t)(captureClock * fps) + 1;
+    if (due > framesDue) {
+        // Start this frame's copy, then collect the oldest slot, which was
+        // queued pboCount - 1 readbacks ago
+        int slot = (int)(frameIndex % pboCount);
+        CollectSlot(slot);
+        rlEnableFramebuffer(target.id);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[slot]);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        rlDisableFramebuffer();
+        slotRun[slot] = run;
+        slotTick[slot] = tick;
+        slotRepeat[slot] = (int)(due - framesDue);
+        slotFilled[slot] = true;
+        framesDue = due;
+        frameIndex++;
+        CollectSlot((int)(frameIndex % pboCount));
+    }
+
+    double end = GetTime();
+    captureTime += end - start;
+    captureMax = std::max(captureMax, end - start);
+    if (lastFrameTime > 0.0) {
+        frameIntervalSum += start - lastFrameTime;
+    }
+    lastFrameTime = start;
+    statFrames++;
+    if (end - statTimer >= 1.0) {
+        LogStats(false);
+        statTimer = end;
+    }
+#else
+    (void)target; (void)dt; (void)run; (void)tick;
+#endif
+}
+
+// Maps a filled slot and hands its pixels to the worker
+void FrameCapture::CollectSlot(int slot)
+{
+#ifndef __EMSCRIPTEN__
+    if (!slotFilled[slot]) return;
+    slotFilled[slot] = false;
+
+    CapturedFrame frame;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (freeFrames.empty()) {
+            // The worker is behind; skip the image rather than stall the game.
+            // The next image covers its output frames, so timing is kept.
+            framesDropped++;
+            carryRepeat += slotRepeat[slot];
+            return;
+        }
+        frame = std::move(freeFrames.back());
+        freeFrames.pop_back();
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo[slot]);
+    const void* pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)frameBytes, GL_MAP_READ_BIT);
+    if (pixels) {
+        memcpy(frame.rgba.data(), pixels, frameBytes);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    frame.run = slotRun[slot];
+    frame.tick = slotTick[slot];
+    frame.repeat = slotRepeat[slot];
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (pixels) {
+            frame.repeat += carryRepeat;
+            carryRepeat = 0;
+            framesWritten += frame.repeat;
+            pending.push_back(std::move(frame));
+        } else {
+            freeFrames.push_back(std::move(frame));
+            framesDropped++;
+            carryRepeat += slotRepeat[slot];
+        }
+    }
+    queueCondition.notify_one();
+#else
+    (void)slot;
+#endif
+}
+
+void FrameCapture::LogStats(bool final)
+{
+    double encodeAverage;
+    uint64_t written;
+    uint64_t dropped;
+#ifndef __EMSCRIPTEN__
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        encodeAverage = framesEncoded > 0 ? encodeTime * 1000.0 / framesEncoded : 0.0;
+        written = framesWritten;
+        dropped = framesDropped;
+    }
+#else
+    encodeAverage = 0.0;
+    written = framesWritten;
+    dropped = framesDropped;
+#endif
+    double captureAverage = statFrames > 0 ? captureTime * 1000.0 / statFrames : 0.0;
+    double intervalAverage = statFrames > 1 ? frameIntervalSum * 1000.0 / (statFrames - 1) : 0.0;
+    double overhead = intervalAverage > 0.0 ? captureAverage * 100.0 / intervalAverage : 0.0;
+
+    if (final) {
+        TraceLog(LOG_INFO, "CAPTURE: wrote %llu frames (%llu dropped) to %s",
+            (unsigned long long)written, (unsigned long long)dropped, path.c_str());
+    }
+    TraceLog(LOG_INFO, "CAPTURE: game thread %.3f ms/frame (max %.3f, %.1f%% of %.2f ms frame), encode %.3f ms/frame, %llu dropped",
+        captureAverage, captureMax * 1000.0, overhead, intervalAverage, encodeAverage, (unsigned long long)dropped);
+
+    captureTime = 0.0;
+    captureMax = 0.0;
+    frameIntervalSum = 0.0;
+    lastFrameTime = 0.0;
+    statFrames = 0;
+}
+
+#ifndef __EMSCRIPTEN__
+void FrameCapture::WorkerLoop()
+{
+    std::vector<uint8_t> yuv((size_t)width * height * 3 / 2);
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (true) {
+        queueCondition.wait(lock, [this] { return stopWorker || !pending.empty(); });
+        if (pending.empty()) break;
+
+        CapturedFrame frame = std::move(pending.front());
+        pending.pop_front();
+        lock.unlock();
+        double start = GetTime();
+        WriteFrame(frame, yuv);
+        double elapsed = GetTime() - start;
+        lock.lock();
+        encodeTime += elapsed;
+        framesEncoded++;
+        freeFrames.push_back(std::move(frame));
+    }
+}
+
+// Full range BT.601 (C420jpeg), chroma averaged over 2x2 blocks. GL rows
+// start at the bottom, so the image is flipped on the way out.
+void FrameCapture::WriteFrame(const CapturedFrame& frame, std::vector<uint8_t>& yuv)
+{
+    uint8_t* planeY = yuv.data();
+    uint8_t* planeU = planeY + (size_t)width * height;
+    uint8_t* planeV = planeU + (size_t)(width / 2) * (height / 2);
+    const uint8_t* rgba = frame.rgba.data();
+
+    for (int y = 0; y < height; y++) {
+        const uint8_t* row = rgba + (size_t)(height - 1 - y) * width * 4;
+        uint8_t* outY = planeY + (size_t)y * width;
+        for (int x = 0; x < width; x++) {
+            int r = row[x * 4 + 0];
+            int g = row[x * 4 + 1];
+            int b = row[x * 4 + 2];
+            outY[x] = (uint8_t)((77 * r + 150 * g + 29 * b + 128) >> 8);
+        }
+    }
+    for (int y = 0; y < height / 2; y++) {
+        const uint8_t* row0 = rgba + (size_t)(height - 1 - 2 * y) * width * 4;
+        const uint8_t* row1 = row0 - (size_t)width * 4;
+        uint8_t* outU = planeU + (size_t)y * (width / 2);
+        uint8_t* outV = planeV + (size_t)y * (width / 2);
+        for (int x = 0; x < width / 2; x++) {
+            const uint8_t* p0 = row0 + x * 8;
+            const uint8_t* p1 = row1 + x * 8;
+            int r = p0[0] + p0[4] + p1[0] + p1[4];
+            int g = p0[1] + p0[5] + p1[1] + p1[5];
+            int b = p0[2] + p0[6] + p1[2] + p1[6];
+            int u = (-43 * r - 85 * g + 128 * b + 512) / 1024 + 128;
+            int v = (128 * r - 107 * g - 21 * b + 512) / 1024 + 128;
+            outU[x] = (uint8_t)MAX(0, MIN(u, 255));
+            outV[x] = (uint8_t)MAX(0, MIN(v, 255));
+        }
+    }
+
+    for (int i = 0; i < frame.repeat; i++) {
+        fprintf(file, "FRAME Xrun=%u Xtick=%u\n", frame.run, frame.tick);
+        fwrite(yuv.data(), 1, yuv.size(), file);
+    }
+}
+#endif
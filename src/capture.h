@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#ifndef __EMSCRIPTEN__
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+#include "raylib.h"
+
+// In-game video capture for QA clips and performance bug reports. Each frame
+// of the game's render texture is read back into a ring of pixel buffer
+// objects, and a PBO is mapped only once it is a couple of frames old. By
+// then the copy has finished, so the game thread never waits on the GPU. A
+// worker thread converts the frames to 4:2:0 and writes them to a raw .y4m
+// file. Each FRAME line is tagged with the run and simulation tick so video
+// lines up with the run's input log. The clip keeps the header's frame rate
+// in game time: frames drawn between two output frames are not read back,
+// and a frame that spans several output frames is written repeatedly.
+// Desktop only: WebGL 1 has no pixel buffer objects.
+class FrameCapture
+{
+public:
+    FrameCapture();
+    ~FrameCapture();
+    bool Start(const std::string& path, int width, int height, int fps);
+    void Stop();
+    bool IsActive() const { return active; }
+
+    // Queues a readback of target if an output frame is due; call after
+    // EndTextureMode with the game time the frame covers
+    void CaptureFrame(const RenderTexture2D& target, float dt, unsigned int run, unsigned int tick);
+
+private:
+    struct CapturedFrame {
+        std::vector<uint8_t> rgba;
+        unsigned int run;
+        unsigned int tick;
+        int repeat;  // Output frames this image stands for
+    };
+
+    static const int pboCount = 3;
+    static const size_t maxQueuedFrames = 8;  // Frames beyond this are dropped, never waited on
+
+    void CollectSlot(int slot);
+    void LogStats(bool final);
+
+    bool active;
+    std::string path;
+    int width;
+    int height;
+    int fps;
+    double captureClock;     // Game time since Start
+    uint64_t framesDue;      // Output frames issued so far
+    int carryRepeat;         // Output frames of dropped images, added to the next one
+    size_t frameBytes;
+    unsigned int pbo[pboCount];
+    unsigned int slotRun[pboCount];
+    unsigned int slotTick[pboCount];
+    int slotRepeat[pboCount];
+    bool slotFilled[pboCount];
+    uint64_t frameIndex;
+
+    // Overhead accounting: game thread time spent in CaptureFrame against the
+    // frame interval, and worker time spent converting and writing
+    double captureTime;
+    double captureMax;
+    double frameIntervalSum;
+    double lastFrameTime;
+    int statFrames;
+    double statTimer;
+    uint64_t framesWritten;
+    uint64_t framesDropped;
+    double encodeTime;
+    uint64_t framesEncoded;
+
+#ifndef __EMSCRIPTEN__
+    void WorkerLoop();
+    void WriteFrame(const CapturedFrame& frame, std::vector<uint8_t>& yuv);
+
+    FILE* file;
+    std::thread worker;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::deque<CapturedFrame> pending;
+    std::vector<CapturedFrame> freeFrames;  // Recycled so capturing never allocates
+    bool stopWorker;
+#endif
+};
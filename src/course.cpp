@@ -0,0 +1,229 @@
+#include <cstring>
+#include <fstream>
+
+#include "course.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+#define COURSE_POSIX_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool WriteCourse(const std::string& path, const std::vector<CourseEntry>& pipes, uint32_t chunkSize)
+{
+    if (pipes.empty() || chunkSize == 0) return false;
+
+    CourseHeader header = {};
+    memcpy(header.magic, "HCRS", 4);
+    header.version = courseFormatVersion;
+    header.pipeCount = (uint32_t)pipes.size();
+    header.chunkSize = chunkSize;
+    header.chunkCount = (header.pipeCount + chunkSize - 1) / chunkSize;
+
+    std::vector<CourseChunk> chunks(header.chunkCount);
+    uint64_t recordsStart = sizeof(CourseHeader) + sizeof(CourseChunk) * (uint64_t)header.chunkCount;
+    for (uint32_t c = 0; c < header.chunkCount; c++) {
+        chunks[c].startDistance = pipes[(size_t)c * chunkSize].distance;
+        chunks[c].offset = recordsStart + (uint64_t)c * chunkSize * sizeof(CoursePipe);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+    file.write((const char*)&header, sizeof(header));
+    file.write((const char*)chunks.data(), sizeof(CourseChunk) * chunks.size());
+    for (size_t i = 0; i < pipes.size(); i++) {
+        CoursePipe record = pipes[i].pipe;
+        record.distance = (float)(pipes[i].distance - chunks[i / chunkSize].startDistance);
+        file.write((const char*)&record, sizeof(record));
+    }
+    return file.good();
+}
+
+CourseStream::CourseStream()
+{
+    header = {};
+    next = 0;
+    loadedChunk = 0;
+    current = {};
+    mapped = nullptr;
+    mappedSize = 0;
+#ifdef _WIN32
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+#endif
+}
+
+CourseStream::~CourseStream()
+{
+    Close();
+}
+
+bool CourseStream::Open(const std::string& path)
+{
+    Close();
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+    CourseHeader fileHeader;
+    if (!file.read((char*)&fileHeader, sizeof(fileHeader))) return false;
+    if (memcmp(fileHeader.magic, "HCRS", 4) != 0 || fileHeader.version != courseFormatVersion) return false;
+    if (fileHeader.pipeCount == 0 || fileHeader.chunkSize == 0) return false;
+    if (fileHeader.chunkCount != (fileHeader.pipeCount + fileHeader.chunkSize - 1) / fileHeader.chunkSize) return false;
+
+    chunks.resize(fileHeader.chunkCount);
+    if (!file.read((char*)chunks.data(), sizeof(CourseChunk) * chunks.size())) return false;
+
+    // Every chunk must lie inside the file
+    file.seekg(0, std::ios::end);
+    uint64_t fileSize = (uint64_t)file.tellg();
+    for (uint32_t c = 0; c < fileHeader.chunkCount; c++) {
+        uint32_t pipesInChunk = (c + 1 < fileHeader.chunkCount) ? fileHeader.chunkSize
+            : fileHeader.pipeCount - c * fileHeader.chunkSize;
+        if (chunks[c].offset % alignof(CoursePipe) != 0 ||
+            chunks[c].offset + (uint64_t)pipesInChunk * sizeof(CoursePipe) > fileSize) {
+            chunks.clear();
+            return false;
+        }
+    }
+    file.close();
+
+#if defined(COURSE_POSIX_MMAP)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        void* address = mmap(nullptr, (size_t)fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (address != MAP_FAILED) {
+            mapped = (const uint8_t*)address;
+            mappedSize = (size_t)fileSize;
+            madvise(address, mappedSize, MADV_RANDOM);  // Paging is driven by LoadChunk
+        }
+    }
+#elif defined(_WIN32)
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle != INVALID_HANDLE_VALUE) {
+        HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr) {
+            void* address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (address != nullptr) {
+                mapped = (const uint8_t*)address;
+                mappedSize = (size_t)fileSize;
+                fileHandle = handle;
+                mappingHandle = mapping;
+            } else {
+                CloseHandle(mapping);
+                CloseHandle(handle);
+            }
+        } else {
+            CloseHandle(handle);
+        }
+    }
+#endif
+
+    this->path = path;
+    header = fileHeader;
+    Rewind();
+    return true;
+}
+
+void CourseStream::Close()
+{
+#if defined(COURSE_POSIX_MMAP)
+    if (mapped) munmap((void*)mapped, mappedSize);
+#elif defined(_WIN32)
+    if (mapped) UnmapViewOfFile(mapped);
+    if (mappingHandle) CloseHandle((HANDLE)mappingHandle);
+    if (fileHandle) CloseHandle((HANDLE)fileHandle);
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+#endif
+    mapped = nullptr;
+    mappedSize = 0;
+    header = {};
+    chunks.clear();
+    chunkBuffer.clear();
+    chunkBuffer.shrink_to_fit();
+    next = 0;
+    loadedChunk = 0;
+}
+
+void CourseStream::Rewind()
+{
+    if (!IsOpen()) return;
+    if (loadedChunk != 0) ReleaseChunk(loadedChunk);
+    next = 0;
+    LoadChunk(0);
+    current.pipe = ChunkPipes(0)[0];
+    current.distance = chunks[0].startDistance + current.pipe.distance;
+}
+
+void CourseStream::Advance()
+{
+    if (Finished()) return;
+    next++;
+    if (Finished()) return;
+
+    uint32_t chunk = next / header.chunkSize;
+    if (chunk != loadedChunk) {
+        ReleaseChunk(loadedChunk);
+        LoadChunk(chunk);
+    }
+    current.pipe = ChunkPipes(chunk)[next % header.chunkSize];
+    current.distance = chunks[chunk].startDistance + current.pipe.distance;
+}
+
+const CoursePipe* CourseStream::ChunkPipes(uint32_t chunk)
+{
+    if (mapped) return (const CoursePipe*)(mapped + chunks[chunk].offset);
+    return chunkBuffer.data();
+}
+
+void CourseStream::LoadChunk(uint32_t chunk)
+{
+    loadedChunk = chunk;
+#if defined(COURSE_POSIX_MMAP)
+    if (mapped) {
+        // Ask for this chunk and the one after it so crossing into the next
+        // chunk never waits on disk
+        long pageSize = sysconf(_SC_PAGESIZE);
+        uint64_t start = chunks[chunk].offset & ~(uint64_t)(pageSize - 1);
+        uint32_t last = (chunk + 1 < header.chunkCount) ? chunk + 1 : chunk;
+        uint64_t end = chunks[last].offset + (uint64_t)header.chunkSize * sizeof(CoursePipe);
+        if (end > mappedSize) end = mappedSize;
+        madvise((void*)(mapped + start), (size_t)(end - start), MADV_WILLNEED);
+        return;
+    }
+#endif
+    if (mapped) return;
+
+    // No memory map: read just this chunk into the buffer
+    uint32_t count = (chunk + 1 < header.chunkCount) ? header.chunkSize : header.pipeCount - chunk * header.chunkSize;
+    chunkBuffer.resize(header.chunkSize);
+    std::ifstream file(path, std::ios::binary);
+    file.seekg((std::streamoff)chunks[chunk].offset);
+    file.read((char*)chunkBuffer.data(), sizeof(CoursePipe) * count);
+}
+
+void CourseStream::ReleaseChunk(uint32_t chunk)
+{
+#if defined(COURSE_POSIX_MMAP)
+    if (mapped) {
+        // Drop only whole pages that belong to this chunk; the pages are
+        // re-read from the file if the course is rewound
+        long pageSize = sysconf(_SC_PAGESIZE);
+        uint64_t start = (chunks[chunk].offset + pageSize - 1) & ~(uint64_t)(pageSize - 1);
+        uint64_t end = chunks[chunk].offset + (uint64_t)header.chunkSize * sizeof(CoursePipe);
+        if (end > mappedSize) end = mappedSize;
+        end &= ~(uint64_t)(pageSize - 1);
+        if (end > start) {
+            madvise((void*)(mapped + start), (size_t)(end - start), MADV_DONTNEED);
+        }
+    }
+#else
+    (void)chunk;
+#endif
+}
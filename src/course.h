@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Binary course file (.hcc):
+//   CourseHeader
+//   CourseChunk[chunkCount]      chunk index
+//   CoursePipe[pipeCount]        pipe records, chunkSize per chunk
+// Pipe distances are stored relative to their chunk's start distance so that
+// multi-hour courses stay exact in float. Files are little-endian and read
+// through a memory map where available; only the chunk ahead of the player is
+// kept resident. Nothing in here depends on raylib so tools/ can use it.
+
+struct CourseHeader {
+    char magic[4];        // "HCRS"
+    uint32_t version;
+    uint32_t pipeCount;
+    uint32_t chunkSize;   // Pipes per chunk
+    uint32_t chunkCount;
+    uint32_t reserved;
+};
+
+struct CourseChunk {
+    double startDistance; // Course distance of the chunk's first pipe
+    uint64_t offset;      // File offset of the chunk's first pipe record
+};
+
+struct CoursePipe {
+    float distance;       // Left edge, relative to the chunk's startDistance
+    float gapCenter;
+    float gap;
+    float width;
+    float speed;          // Pipe speed once this pipe is passed, 0 keeps the current speed
+};
+
+const uint32_t courseFormatVersion = 1;
+const uint32_t courseDefaultChunkSize = 1024;
+
+// Pipe with its absolute course distance resolved
+struct CourseEntry {
+    double distance;
+    CoursePipe pipe;
+};
+
+bool WriteCourse(const std::string& path, const std::vector<CourseEntry>& pipes, uint32_t chunkSize = courseDefaultChunkSize);
+
+class CourseStream
+{
+public:
+    CourseStream();
+    ~CourseStream();
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const { return header.pipeCount > 0; }
+    uint32_t PipeCount() const { return header.pipeCount; }
+
+    void Rewind();
+    bool Finished() const { return next >= header.pipeCount; }
+    // The next pipe to spawn; only valid while !Finished()
+    const CourseEntry& Peek() const { return current; }
+    void Advance();
+
+private:
+    void LoadChunk(uint32_t chunk);
+    void ReleaseChunk(uint32_t chunk);
+    const CoursePipe* ChunkPipes(uint32_t chunk);
+
+    std::string path;
+    CourseHeader header;
+    std::vector<CourseChunk> chunks;
+    uint32_t next;
+    uint32_t loadedChunk;
+    CourseEntry current;
+
+    // Memory map of the whole file, or a one-chunk buffer where mmap is unavailable
+    const uint8_t* mapped;
+    size_t mappedSize;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+    std::vector<CoursePipe> chunkBuffer;
+};
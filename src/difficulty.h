@@ -0,0 +1,13 @@
+#pragma once
+
+// Physics and course constants that set how hard a run is. Game uses the
+// defaults below; tools/difficulty_tuner sweeps them with simulated bots.
+struct DifficultyParams {
+    float gravity = 1200.0f;
+    float jumpForce = -400.0f;
+    float pipeGap = 230.0f;
+    float maxGapHeightDifference = 100.0f;  // Maximum allowed vertical distance between consecutive pipe gaps
+    float pipeSpeedIncrease = 10.0f;  // Speed increase per second
+    float maxSpeed = 1200.0f;
+    bool scalePhysicsWithSpeed = false;  // Scale gravity and jump force with pipeSpeed / basePipeSpeed
+};
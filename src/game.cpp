@@ -4,6 +4,7 @@
 #include <cmath>  // For sqrtf
 #include <algorithm> // For std::remove_if
 #include <fstream>
+#include <ctime>
 
 #include "raylib.h"
 #include "globals.h"
@@ -15,6 +16,10 @@
 
 //#define DEBUG
 
+#ifndef HOVERCAT_BUILD_ID
+#define HOVERCAT_BUILD_ID __DATE__ " " __TIME__
+#endif
+
 bool Game::isMobile = false;
 
 Game::Game(int width, int height)
@@ -26,19 +31,29 @@ Game::Game(int width, int height)
 
     // Initialize Flappy Bird variables
     playerSize = 80.0f;
+    playerCount = 1;
     playerX = width / 4;
-    playerY = height / 2;
-    playerVelocity = 0.0f;
-    gravity = defaultGravity;
-    jumpForce = defaultJumpForce;
+    for (int i = 0; i < maxPlayers; i++) {
+        playerY[i] = height / 2;
+        playerVelocity[i] = 0.0f;
+        playerAlive[i] = true;
+        playerScore[i] = 0;
+        playerDownTick[i] = 0;
+        playerEyesClosedTimer[i] = 0.0f;
+    }
+    lastPlayerDown = 0;
+    gravity = difficulty.gravity;
+    jumpForce = difficulty.jumpForce;
     pipeWidth = defaultPipeWidth;
-    pipeGap = defaultPipeGap;
+    pipeGap = difficulty.pipeGap;
     pipeSpeed = defaultPipeSpeed;
     basePipeSpeed = pipeSpeed;  // Store initial speed
     pipeSpawnInterval = defaultPipeSpawnInterval;
     pipeSpawnTimer = pipeSpawnInterval;  // Initialize to spawn interval to trigger immediate spawn
     initialPipeDistance = basePipeSpeed * pipeSpawnInterval;  // Store initial distance between pipes
     speedLevel = 0;             // Start at level 0
+    courseMode = false;
+    courseDistance = 0.0;
 
     // Initialize sounds
     gameMusic = LoadMusicStream("Data/music.mp3");
@@ -54,6 +69,26 @@ Game::Game(int width, int height)
     score = 0;
     LoadHighScore();
 
+    UpdateLeaderboardMode();
+    runSeed = 0;
+    fixedSeed = 0;
+    seedFixed = false;
+    runTime = 0.0f;
+    runMaxSpeed = 0.0f;
+    recordInputs = false;
+    frameTime = 0.0f;
+    replaying = false;
+    flapped = 0;
+    replayFlags = 0;
+    // Opened from the first Update, on the web once IndexedDB has been
+    // loaded. --render-golden only draws, so its title screen never shows a
+    // best score from the local leaderboard.
+    LeaderboardMountStorage();
+
+    runNumber = 0;
+    tick = 0;
+    analytics.Open("analytics.bin", HOVERCAT_BUILD_ID);
+
     playerCollisionWidthRatio = 0.70f;
     playerCollisionHeightRatio = 0.55f;
 
@@ -74,24 +109,32 @@ Game::Game(int width, int height)
     this->height = height;
 
     // Background initialization
-    backgroundTexture = LoadTexture("Data/background.jpg");
-    backgroundScrollX = 0.0f;
-    backgroundScrollSpeed = basePipeSpeed * 0.2f;  // Set initial scroll speed to 20% of pipe speed
+    background.Load(gameScreenWidth, gameScreenHeight);
     playerTexture = LoadTexture("Data/redkat_eyes_open.png");
     playerTextureEyesClosed = LoadTexture("Data/redkat_eyes_closed.png");
-    playerEyesClosedTimer = 0.0f;
     InitGame();
 
     pipeTexture = LoadTexture("Data/pipe.png");
+
+    Image particleImage = GenImageColor(4, 4, WHITE);
+    particleTexture = LoadTextureFromImage(particleImage);
+    UnloadImage(particleImage);
+    particleStress = false;
+    particleUpdateTime = 0.0;
+    particleDrawTime = 0.0;
+    particleTimedFrames = 0;
+    particleReportTimer = 0.0;
 }
 
 Game::~Game()
 {
+    capture.Stop();
+    postProcess.Unload();
     UnloadRenderTexture(targetRenderTex);
     UnloadFont(font);
 
-    // Unload background texture
-    UnloadTexture(backgroundTexture);
+    // Unload background layers
+    background.Unload();
 
     // Unload sounds
     UnloadMusicStream(gameMusic);
@@ -101,6 +144,7 @@ Game::~Game()
     UnloadTexture(playerTexture);
     UnloadTexture(playerTextureEyesClosed);
     UnloadTexture(pipeTexture);
+    UnloadTexture(particleTexture);
     // Close audio device
     CloseAudioDevice();
 }
@@ -111,6 +155,7 @@ void Game::InitGame()
     paused = false;
     lostWindowFocus = false;
     gameOver = false;
+    courseComplete = false;
 
     screenScale = MIN((float)GetScreenWidth() / gameScreenWidth, (float)GetScreenHeight() / gameScreenHeight);
 }
@@ -118,18 +163,34 @@ void Game::InitGame()
 void Game::Reset()
 {
     InitGame();
-    // Reset player position and velocity
+    // Reset player positions and velocities
     playerX = width / 4;
-    playerY = height / 2;
-    playerVelocity = 0.0f;
+    for (int i = 0; i < playerCount; i++) {
+        playerY[i] = height / 2;
+        playerVelocity[i] = 0.0f;
+        playerAlive[i] = true;
+        playerScore[i] = 0;
+        playerDownTick[i] = 0;
+        playerEyesClosedTimer[i] = 0.0f;
+    }
     // Clear all pipes
     pipes.clear();
+    courseDistance = 0.0;
+    course.Rewind();
+    particles.Clear();
     pipeSpawnTimer = 0.0f;
     pipeSpawnInterval = 2.0f;
     // Reset score and speed
     score = 0;
     speedLevel = 0;
     pipeSpeed = basePipeSpeed;
+    runTime = 0.0f;
+    runMaxSpeed = 0.0f;
+    Randomize();
+    runNumber++;
+    tick = 0;
+    LogEvent(ANALYTICS_RUN_START);
+    BeginInputLog();
     
     // Only restart music if it wasn't manually disabled
     if (!musicManuallyDisabled) {
@@ -140,12 +201,17 @@ void Game::Reset()
 
 void Game::Update(float dt)
 {
+    frameTime = dt;
     if (dt == 0)
     {
         return;
     }
 
     screenScale = MIN((float)GetScreenWidth() / gameScreenWidth, (float)GetScreenHeight() / gameScreenHeight);
+    if (!leaderboard.IsOpen() && LeaderboardStorageReady()) {
+        OpenLeaderboard();
+    }
+
     bool skipFrame = UpdateUI();
     if(skipFrame) {
         return;
@@ -153,11 +219,22 @@ void Game::Update(float dt)
 
     bool running = (firstTimeGameStart == false && paused == false && lostWindowFocus == false && isInExitMenu == false && gameOver == false);
 
+    // Replays drive the simulation with the recorded frame times and flaps
+    replayFlags = 0;
+    if (running && replaying) {
+        InputFrame frame;
+        if (inputLog.Next(frame)) {
+            dt = frame.dt;
+            frameTime = dt;
+            replayFlags = frame.flags;
+        } else {
+            replaying = false;
+        }
+    }
+
     // Only scroll background when running
     if (running) {
-        backgroundScrollX += backgroundScrollSpeed * dt;
-        if (backgroundScrollX >= backgroundTexture.width)
-            backgroundScrollX -= backgroundTexture.width;
+        background.Update(dt, pipeSpeed);
     }
 
     if (musicPlaying) {
@@ -166,106 +243,115 @@ void Game::Update(float dt)
 
     if (running)
     {
+        tick++;
+        runTime += dt;
         HandleInput();
+        inputLog.Record(dt, flapped);
 
         UpdatePipeSpeed(dt);
+        runMaxSpeed = MAX(runMaxSpeed, pipeSpeed);
         
         // Update player physics
-        playerVelocity += gravity * dt;
-        playerY += playerVelocity * dt;
+        for (int i = 0; i < playerCount; i++) {
+            if (!playerAlive[i]) continue;
+            playerVelocity[i] += gravity * dt;
+            playerY[i] += playerVelocity[i] * dt;
+        }
 
         // Calculate collision box dimensions
         float collisionBoxWidth = playerSize * playerCollisionWidthRatio;
         float collisionBoxHeight = playerSize * playerCollisionHeightRatio;
 
         // Check for collisions with screen boundaries using collision box
-        if (playerY - collisionBoxHeight/2 < 0 || playerY + collisionBoxHeight/2 > height) {
-            gameOver = true;
-            gameOverDelayTimer = gameOverDelayDuration; // Initialize delay timer
-            // Stop all sounds before playing hit sound
-            StopMusicStream(gameMusic);
-            StopSound(flySound);
-            StopSound(scoreSound);
-            PlaySound(hitSound);
-            if (score > highScore) {
-                highScore = score;
-                SaveHighScore();
+        for (int i = 0; i < playerCount; i++) {
+            if (playerAlive[i] && (playerY[i] - collisionBoxHeight/2 < 0 || playerY[i] + collisionBoxHeight/2 > height)) {
+                KillPlayer(i);
             }
         }
 
-        // Update pipes
-        pipeSpawnTimer += dt;
-        if (pipeSpawnTimer >= pipeSpawnInterval) {
-            pipeSpawnTimer = 0.0f;
-            
-            // Calculate the target gap center based on the previous pipe
-            float targetGapCenter;
-            if (pipes.empty()) {
-                // First pipe - place it in the middle
-                targetGapCenter = height / 2;
-            } else {
-                // Get the previous pipe's gap center
-                float prevGapCenter = pipes.back().gapCenter;
-                
-                // Calculate the minimum and maximum allowed gap center
-                float minGapCenter = MAX(pipeGap/2, prevGapCenter - maxGapHeightDifference);
-                float maxGapCenter = MIN(height - pipeGap/2, prevGapCenter + maxGapHeightDifference);
-                
-                // Randomly choose a new gap center within the allowed range
-                targetGapCenter = GetRandomValue(minGapCenter, maxGapCenter);
-            }
-            
-            pipes.push_back({(float)width, targetGapCenter, false});
-        }
+        SpawnPipes(dt);
 
-        // Move pipes and check collisions
+        // Move pipes and check collisions. All cats share one x, so a pipe
+        // is passed by every cat still flying at the same moment.
         for (auto& pipe : pipes) {
             pipe.x -= pipeSpeed * dt;
             // Check if player has passed the pipe
-            if (playerX > pipe.x + pipeWidth && !pipe.scored) {
-                score++;
+            if (playerX > pipe.x + pipe.width && !pipe.scored) {
                 pipe.scored = true;
-                PlaySound(scoreSound);
-                if (score > highScore) {
-                    highScore = score;
-                    SaveHighScore();
+                int scorer = -1;
+                for (int i = 0; i < playerCount; i++) {
+                    if (!playerAlive[i]) continue;
+                    playerScore[i]++;
+                    score = MAX(score, playerScore[i]);
+                    if (scorer < 0) scorer = i;
+                }
+                if (scorer >= 0) {
+                    if (pipe.speed > 0.0f) {
+                        pipeSpeed = pipe.speed;
+                    }
+                    PlaySound(scoreSound);
+                    LogEvent(ANALYTICS_SCORE, scorer);
+                    if (score > highScore) {
+                        highScore = score;
+                        SaveHighScore();
+                    }
                 }
             }
 
-            // Check collision with pipe using collision box
-            if (!gameOver) {
-                // Check if player is within pipe's x range
-                if (playerX + collisionBoxWidth/2 > pipe.x && playerX - collisionBoxWidth/2 < pipe.x + pipeWidth) {
-                    // Check if player is outside the gap
-                    if (playerY - collisionBoxHeight/2 < pipe.gapCenter - pipeGap/2 || 
-                        playerY + collisionBoxHeight/2 > pipe.gapCenter + pipeGap/2) {
-                        gameOver = true;
-                        gameOverDelayTimer = gameOverDelayDuration; // Initialize delay timer
-                        // Stop all sounds before playing hit sound
-                        StopMusicStream(gameMusic);
-                        StopSound(flySound);
-                        StopSound(scoreSound);
-                        PlaySound(hitSound);
-                        if (score > highScore) {
-                            highScore = score;
-                            SaveHighScore();
-                        }
+            // Check if player is within pipe's x range
+            if (playerX + collisionBoxWidth/2 > pipe.x && playerX - collisionBoxWidth/2 < pipe.x + pipe.width) {
+                for (int i = 0; i < playerCount; i++) {
+                    // Check if player is outside the gap using collision box
+                    if (playerAlive[i] && (playerY[i] - collisionBoxHeight/2 < pipe.gapCenter - pipe.gap/2 ||
+                        playerY[i] + collisionBoxHeight/2 > pipe.gapCenter + pipe.gap/2)) {
+                        KillPlayer(i);
                     }
                 }
             }
         }
 
+        // The run ends when the last cat is down
+        bool anyAlive = false;
+        for (int i = 0; i < playerCount; i++) {
+            anyAlive = anyAlive || playerAlive[i];
+        }
+        if (!anyAlive) {
+            TriggerGameOver();
+        } else if (courseMode && course.Finished()) {
+            // The course is over once the cats still flying have cleared its
+            // last pipe; they all finish together
+            bool allScored = true;
+            for (const auto& pipe : pipes) {
+                allScored = allScored && pipe.scored;
+            }
+            if (allScored) {
+                for (int i = 0; i < playerCount; i++) {
+                    if (playerAlive[i]) playerDownTick[i] = tick;
+                }
+                courseComplete = true;
+                TriggerGameOver();
+            }
+        }
+
         // Remove pipes that are off screen
         pipes.erase(std::remove_if(pipes.begin(), pipes.end(), 
-            [this](const auto& pipe) { return pipe.x < -this->pipeWidth; }), 
+            [](const auto& pipe) { return pipe.x < -pipe.width; }), 
             pipes.end());
 
-        if (playerEyesClosedTimer > 0.0f) {
-            playerEyesClosedTimer -= dt;
-            if (playerEyesClosedTimer < 0.0f) playerEyesClosedTimer = 0.0f;
+        for (int i = 0; i < playerCount; i++) {
+            if (playerEyesClosedTimer[i] > 0.0f) {
+                playerEyesClosedTimer[i] -= dt;
+                if (playerEyesClosedTimer[i] < 0.0f) playerEyesClosedTimer[i] = 0.0f;
+            }
         }
     }
 
+    // Particles keep moving after game over so the crash debris can settle
+    if (!paused && !lostWindowFocus && !isInExitMenu) {
+        UpdateParticles(dt);
+        postProcess.Update(dt, running ? (pipeSpeed - basePipeSpeed) / (difficulty.maxSpeed - basePipeSpeed) : 0.0f);
+    }
+
     // Handle game over restart
     if (gameOver) {
         // Update game over delay timer
@@ -289,15 +375,22 @@ void Game::Update(float dt)
 
 void Game::HandleInput()
 {
+    flapped = 0;
     // Only handle flap input if the game is running and not paused
     if (!paused && !gameOver && !firstTimeGameStart && !isInExitMenu && !lostWindowFocus) {
-        // Flap on keyboard or mobile tap
-        if (IsKeyPressed(KEY_SPACE) || IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_W)
-            || (isMobile && IsGestureDetected(GESTURE_TAP)))
-        {
-            playerVelocity = jumpForce;
-            PlaySound(flySound);
-            playerEyesClosedTimer = playerEyesClosedDuration;
+        for (int i = 0; i < playerCount; i++) {
+            if (!playerAlive[i]) continue;
+            // Flap on the player's own controls, or as recorded when replaying
+            bool flap = replaying ? (replayFlags & (1u << i)) != 0 : IsFlapPressed(i);
+            if (flap)
+            {
+                flapped |= 1u << i;
+                playerVelocity[i] = jumpForce;
+                PlaySound(flySound);
+                playerEyesClosedTimer[i] = playerEyesClosedDuration;
+                particles.EmitFeathers(playerX - playerSize * 0.3f, playerY[i], featherCount);
+                LogEvent(ANALYTICS_FLAP, i);
+            }
         }
     }
 
@@ -347,6 +440,8 @@ bool Game::UpdateUI()
                 // Start music when game begins
                 PlayMusicStream(gameMusic);
                 musicPlaying = true;
+                LogEvent(ANALYTICS_RUN_START);
+                BeginInputLog();
             }
         }
         else if(IsKeyDown(KEY_ENTER)) {
@@ -354,6 +449,8 @@ bool Game::UpdateUI()
             // Start music when game begins
             PlayMusicStream(gameMusic);
             musicPlaying = true;
+            LogEvent(ANALYTICS_RUN_START);
+            BeginInputLog();
         }
     }
 
@@ -386,6 +483,7 @@ bool Game::UpdateUI()
 #endif
     {
         paused = !paused;
+        LogEvent(paused ? ANALYTICS_PAUSE : ANALYTICS_RESUME);
     }
 
     // Handle pausing/unpausing on mobile with tap
@@ -407,10 +505,12 @@ bool Game::UpdateUI()
             // Check if tap is within the title area
             if (CheckCollisionPointRec(tapPos, titleArea)) {
                 paused = true;
+                LogEvent(ANALYTICS_PAUSE);
                 return true;
             }
         } else if (paused && IsGestureDetected(GESTURE_TAP)) {
             paused = false;
+            LogEvent(ANALYTICS_RESUME);
             return true;
         }
     }
@@ -421,39 +521,15 @@ void Game::Draw()
 {
     // render everything to a texture
     BeginTextureMode(targetRenderTex);
+    renderer.BeginFrame(gameScreenWidth, gameScreenHeight);
 
-    // Draw scrolling background (revert to original logic)
-    float srcX = backgroundScrollX;
-    float srcWidth = (float)gameScreenWidth;
-    if (srcX + srcWidth <= backgroundTexture.width) {
-        // No wrap needed
-        DrawTexturePro(
-            backgroundTexture,
-            { srcX, 0, srcWidth, (float)gameScreenHeight },
-            { 0, 0, srcWidth, (float)gameScreenHeight },
-            { 0, 0 }, 0.0f, WHITE
-        );
-    } else {
-        // Wrap around
-        float firstPart = backgroundTexture.width - srcX;
-        DrawTexturePro(
-            backgroundTexture,
-            { srcX, 0, firstPart, (float)gameScreenHeight },
-            { 0, 0, firstPart, (float)gameScreenHeight },
-            { 0, 0 }, 0.0f, WHITE
-        );
-        DrawTexturePro(
-            backgroundTexture,
-            { 0, 0, srcWidth - firstPart, (float)gameScreenHeight },
-            { firstPart, 0, srcWidth - firstPart, (float)gameScreenHeight },
-            { 0, 0 }, 0.0f, WHITE
-        );
-    }
+    // Draw all background layers in one pass
+    background.Draw(renderer);
 
     // Draw pipes with graphics
     for (const auto& pipe : pipes) {
-        float topPipeHeight = pipe.gapCenter - pipeGap/2;
-        float bottomPipeY = pipe.gapCenter + pipeGap/2;
+        float topPipeHeight = pipe.gapCenter - pipe.gap/2;
+        float bottomPipeY = pipe.gapCenter + pipe.gap/2;
         float bottomPipeHeight = height - bottomPipeY;
 
         int capHeight = 24; // Set this to the cap height in your image
@@ -466,19 +542,19 @@ void Game::Draw()
             // Draw body (stretched)
             float bodyDrawHeight = topPipeHeight - capHeight;
             if (bodyDrawHeight > 0) {
-                DrawTexturePro(
+                renderer.Texture(
                     pipeTexture,
                     { 0, (float)capHeight, (float)pipeImgWidth, (float)bodyHeight },
-                    { pipe.x, 0, pipeWidth, bodyDrawHeight },
-                    { 0, 0 }, 0.0f, WHITE
+                    { pipe.x, 0, pipe.width, bodyDrawHeight },
+                    WHITE
                 );
             }
             // Draw cap (flipped)
-            DrawTexturePro(
+            renderer.Texture(
                 pipeTexture,
                 { 0, 0, (float)pipeImgWidth, (float)capHeight },
-                { pipe.x, bodyDrawHeight, pipeWidth, (float)capHeight },
-                { 0, 0 }, 0.0f, WHITE
+                { pipe.x, bodyDrawHeight, pipe.width, (float)capHeight },
+                WHITE
             );
         }
 
@@ -487,69 +563,129 @@ void Game::Draw()
             // Draw body (stretched)
             float bodyDrawHeight = bottomPipeHeight - capHeight;
             if (bodyDrawHeight > 0) {
-                DrawTexturePro(
+                renderer.Texture(
                     pipeTexture,
                     { 0, (float)capHeight, (float)pipeImgWidth, (float)bodyHeight },
-                    { pipe.x, bottomPipeY + (float)capHeight, pipeWidth, bodyDrawHeight },
-                    { 0, 0 }, 0.0f, WHITE
+                    { pipe.x, bottomPipeY + (float)capHeight, pipe.width, bodyDrawHeight },
+                    WHITE
                 );
             }
             // Draw cap (normal)
-            DrawTexturePro(
+            renderer.Texture(
                 pipeTexture,
                 { 0, 0, (float)pipeImgWidth, (float)capHeight },
-                { pipe.x, bottomPipeY, pipeWidth, (float)capHeight },
-                { 0, 0 }, 0.0f, WHITE
+                { pipe.x, bottomPipeY, pipe.width, (float)capHeight },
+                WHITE
             );
         }
     }
 
-    // Choose player texture:
-    Texture2D currentPlayerTexture;
-    if (gameOver) {
-        // If crashed, always show eyes closed
-        currentPlayerTexture = playerTextureEyesClosed;
-    } else if (playerEyesClosedTimer > 0.0f) {
-        // If flapping, show eyes closed
-        currentPlayerTexture = playerTextureEyesClosed;
-    } else {
-        // Otherwise, show eyes open
-        currentPlayerTexture = playerTexture;
+    double particleDrawStart = GetTime();
+    particles.Draw(renderer, particleTexture);
+    particleDrawTime += GetTime() - particleDrawStart;
+
+    // Draw the cats grouped by texture, so any number of players costs at
+    // most two batched draws
+    for (int pass = 0; pass < 2; pass++) {
+        bool eyesClosedPass = (pass == 1);
+        const Texture2D& currentPlayerTexture = eyesClosedPass ? playerTextureEyesClosed : playerTexture;
+        for (int i = 0; i < playerCount; i++) {
+            // Cats that crash mid-race leave the screen; the last one down stays
+            if (!playerAlive[i] && !(gameOver && i == lastPlayerDown)) continue;
+            // Eyes closed when crashed or flapping
+            bool eyesClosed = (gameOver && !courseComplete) || playerEyesClosedTimer[i] > 0.0f;
+            if (eyesClosed != eyesClosedPass) continue;
+            renderer.Texture(
+                currentPlayerTexture,
+                { 0, 0, (float)currentPlayerTexture.width, (float)currentPlayerTexture.height },
+                { playerX - playerSize/2, playerY[i] - playerSize/2, playerSize, playerSize },
+                playerTint[i]
+            );
+        }
     }
 
-    DrawTexturePro(
-        currentPlayerTexture,
-        { 0, 0, (float)currentPlayerTexture.width, (float)currentPlayerTexture.height },
-        { playerX - playerSize/2, playerY - playerSize/2, playerSize, playerSize },
-        { 0, 0 }, 0.0f, WHITE
-    );
-
 #ifdef DEBUG
     // Draw player collision box for debugging (red outline)
     float collisionBoxWidth = playerSize * playerCollisionWidthRatio;
     float collisionBoxHeight = playerSize * playerCollisionHeightRatio;
-    DrawRectangleLines(
-        (int)(playerX - collisionBoxWidth/2),
-        (int)(playerY - collisionBoxHeight/2),
-        (int)collisionBoxWidth,
-        (int)collisionBoxHeight,
-        RED
-    );
+    for (int i = 0; i < playerCount; i++) {
+        renderer.RectLines(
+            (int)(playerX - collisionBoxWidth/2),
+            (int)(playerY[i] - collisionBoxHeight/2),
+            (int)collisionBoxWidth,
+            (int)collisionBoxHeight,
+            RED
+        );
+    }
 #endif
     DrawUI();
 
+    renderer.EndFrame();
     EndTextureMode();
+    capture.CaptureFrame(targetRenderTex, frameTime, runNumber, tick);
 
-    // render the scaled frame texture to the screen
+    // render the scaled frame texture to the screen, with any post effects
     BeginDrawing();
     ClearBackground(BLACK);
-    DrawTexturePro(targetRenderTex.texture, 
+    postProcess.Draw(targetRenderTex.texture,
         (Rectangle){0.0f, 0.0f, (float)targetRenderTex.texture.width, (float)-targetRenderTex.texture.height},
-        (Rectangle){(GetScreenWidth() - ((float)gameScreenWidth * screenScale)) * 0.5f, (GetScreenHeight() - ((float)gameScreenHeight * screenScale)) * 0.5f, (float)gameScreenWidth * screenScale, (float)gameScreenHeight * screenScale},
-        (Vector2){0, 0}, 0.0f, WHITE);
+        ScreenRect());
     EndDrawing();
 }
 
+Rectangle Game::ScreenRect() const
+{
+    return (Rectangle){(GetScreenWidth() - ((float)gameScreenWidth * screenScale)) * 0.5f, (GetScreenHeight() - ((float)gameScreenHeight * screenScale)) * 0.5f, (float)gameScreenWidth * screenScale, (float)gameScreenHeight * screenScale};
+}
+
+void Game::BenchmarkPostProcess(int frames)
+{
+    // Each effect alone and all together, timed as repeated fullscreen
+    // passes; the plain upscale is the baseline the costs are relative to
+    struct BenchConfig {
+        const char* name;
+        unsigned int effects;
+    };
+    const BenchConfig configs[] = {
+        { "plain", 0 },
+        { "sharpen", POST_SHARPEN },
+        { "vignette", POST_VIGNETTE },
+        { "motion blur", POST_MOTION_BLUR },
+        { "hit flash", POST_HIT_FLASH },
+        { "crt", POST_CRT },
+        { "all", POST_EFFECT_COMBINATIONS - 1 },
+    };
+    const int passesPerFrame = 8;  // Lifts the pass cost above the swap overhead
+    const int warmupFrames = 10;
+
+    SetTargetFPS(0);
+    Draw();  // Fills targetRenderTex with the current scene
+    Rectangle source = {0.0f, 0.0f, (float)targetRenderTex.texture.width, (float)-targetRenderTex.texture.height};
+    Rectangle dest = ScreenRect();
+    TraceLog(LOG_INFO, "POSTFX: %d frames of %d passes at %dx%d", frames, passesPerFrame, (int)dest.width, (int)dest.height);
+
+    double baseline = 0.0;
+    for (const BenchConfig& config : configs) {
+        postProcess.SetEffects(config.effects);
+        postProcess.TriggerHitFlash();
+        postProcess.Update(0.0f, 1.0f);  // Full speed blur, flash held at full
+
+        double start = 0.0;
+        for (int frame = -warmupFrames; frame < frames; frame++) {
+            if (frame == 0) start = GetTime();
+            BeginDrawing();
+            ClearBackground(BLACK);
+            for (int pass = 0; pass < passesPerFrame; pass++) {
+                postProcess.Draw(targetRenderTex.texture, source, dest);
+            }
+            EndDrawing();
+        }
+        double perPass = (GetTime() - start) * 1000.0 / frames / passesPerFrame;
+        if (config.effects == 0) baseline = perPass;
+        TraceLog(LOG_INFO, "POSTFX: %-12s %.4f ms per pass (%+.4f ms vs plain)", config.name, perPass, perPass - baseline);
+    }
+}
+
 void Game::DrawUI()
 {
     float screenX = 0.0f;
@@ -558,109 +694,149 @@ void Game::DrawUI()
     if(isMobile) {
         // Draw pause rectangle area at the top of the screen
         Color grayTransparent = {128, 128, 128, 8}; // Semi-transparent gray
-        DrawRectangle(0, 0, gameScreenWidth, 100, grayTransparent);
+        renderer.Rect(0, 0, gameScreenWidth, 100, grayTransparent);
         
         // Draw centered "Tap to pause" text
         const char* text = "Tap to pause";
         int fontSize = 20;
-        int textWidth = MeasureText(text, fontSize);
-        DrawText(text, (gameScreenWidth - textWidth)/2, 40, fontSize, BLACK);
+        int textWidth = renderer.TextWidth(text, fontSize);
+        renderer.Text(text, (gameScreenWidth - textWidth)/2, 40, fontSize, BLACK);
     }
 
     // Draw score on the right side
     std::string scoreText = "Score: " + std::to_string(score);
     std::string highScoreText = "High Score: " + std::to_string(highScore);
     std::string speedText = "Speed: " + std::to_string((int)pipeSpeed);
-    int scoreWidth = MeasureText(scoreText.c_str(), 20);
-    int highScoreWidth = MeasureText(highScoreText.c_str(), 20);
-    int speedWidth = MeasureText(speedText.c_str(), 20);
+    int scoreWidth = renderer.TextWidth(scoreText.c_str(), 20);
+    int highScoreWidth = renderer.TextWidth(highScoreText.c_str(), 20);
+    int speedWidth = renderer.TextWidth(speedText.c_str(), 20);
     int rightPadding = 20;
     
-    DrawText(scoreText.c_str(), width - scoreWidth - rightPadding, 20, 20, BLACK);
-    DrawText(highScoreText.c_str(), width - highScoreWidth - rightPadding, 50, 20, BLACK);
-    DrawText(speedText.c_str(), width - speedWidth - rightPadding, 80, 20, BLACK);
+    renderer.Text(scoreText.c_str(), width - scoreWidth - rightPadding, 20, 20, BLACK);
+    renderer.Text(highScoreText.c_str(), width - highScoreWidth - rightPadding, 50, 20, BLACK);
+    renderer.Text(speedText.c_str(), width - speedWidth - rightPadding, 80, 20, BLACK);
+
+    if (playerCount > 1) {
+        // Race standings on the left, in each cat's tint
+        for (int i = 0; i < playerCount; i++) {
+            std::string playerText = "P" + std::to_string(i + 1) + ": " + std::to_string(playerScore[i]) + (playerAlive[i] ? "" : " (down)");
+            renderer.Rect(20, 20 + 30 * i, 14, 14, playerTint[i]);
+            renderer.Text(playerText.c_str(), 42, 17 + 30 * i, 20, BLACK);
+        }
+    }
 
     if(!isMobile) {
         // Draw music toggle instruction at the bottom
         const char* musicText = "Press M to toggle music";
-        int musicTextWidth = MeasureText(musicText, 20);
-        DrawText(musicText, (gameScreenWidth - musicTextWidth)/2, gameScreenHeight - 30, 20, BLACK);
+        int musicTextWidth = renderer.TextWidth(musicText, 20);
+        renderer.Text(musicText, (gameScreenWidth - musicTextWidth)/2, gameScreenHeight - 30, 20, BLACK);
     }
 
     if (exitWindowRequested)
     {
-        DrawRectangleRounded({screenX + (float)(gameScreenWidth / 2 - 250), screenY + (float)(gameScreenHeight / 2 - 20), 500, 60}, 0.76f, 20, BLACK);
-        DrawText("Are you sure you want to exit? [Y/N]", screenX + (gameScreenWidth / 2 - 200), screenY + gameScreenHeight / 2, 20, yellow);
+        renderer.RectRounded({screenX + (float)(gameScreenWidth / 2 - 250), screenY + (float)(gameScreenHeight / 2 - 20), 500, 60}, 0.76f, 20, BLACK);
+        renderer.Text("Are you sure you want to exit? [Y/N]", screenX + (gameScreenWidth / 2 - 200), screenY + gameScreenHeight / 2, 20, yellow);
     }
     else if (firstTimeGameStart)
     {
-        DrawRectangleRounded(
+        renderer.RectRounded(
             {screenX + (float)(gameScreenWidth / 2 - 320), screenY + (float)(gameScreenHeight / 2 - 130), 700, 300},
             0.76f, 20, BLACK
         );
 
         // Welcome and instructions
         int y = (int)(screenY + (gameScreenHeight / 2 - 110));
-        DrawText("Welcome to Hovercat", (int)(screenX + (gameScreenWidth / 2 - 260)), y, 20, yellow);
+        renderer.Text("Welcome to Hovercat", (int)(screenX + (gameScreenWidth / 2 - 260)), y, 20, yellow);
         y += 40;
-        DrawText("Controls:", (int)(screenX + (gameScreenWidth / 2 - 260)), y, 20, yellow);
+        renderer.Text("Controls:", (int)(screenX + (gameScreenWidth / 2 - 260)), y, 20, yellow);
         y += 30;
         if(!isMobile) {
-            DrawText("- Press [Space], [W] or [Up Arrow] to flap", (int)(screenX + (gameScreenWidth / 2 - 220)), y, 20, WHITE);
+            if (playerCount > 1) {
+                renderer.Text("- Flap: P1 [W], P2 [Up], P3 [I], P4 [Num 8] or gamepad", (int)(screenX + (gameScreenWidth / 2 - 220)), y, 20, WHITE);
+            } else {
+                renderer.Text("- Press [Space], [W] or [Up Arrow] to flap", (int)(screenX + (gameScreenWidth / 2 - 220)), y, 20, WHITE);
+            }
             y += 30;
 #ifndef EMSCRIPTEN_BUILD
-            DrawText("- Press [P] to pause", (int)(screenX + (gameScreenWidth / 2 - 220)), y, 20, WHITE);
+            renderer.Text("- Press [P] to pause", (int)(screenX + (gameScreenWidth / 2 - 220)), y, 20, WHITE);
             y += 30;
-            DrawText("- Press [Esc] to exit", (int)(screenX + (gameScreenWidth / 2 - 220)), y, 20, WHITE);
+            renderer.Text("- Press [Esc] to exit", (int)(screenX + (gameScreenWidth / 2 - 220)), y, 20, WHITE);
             y += 30;
-            DrawText("- Press [M] to toggle music", (int)(screenX + (gameScreenWidth / 2 - 220)), y, 20, WHITE);
+            renderer.Text("- Press [M] to toggle music", (int)(screenX + (gameScreenWidth / 2 - 220)), y, 20, WHITE);
             y += 40;
-            DrawText("Press Enter to play", (int)(screenX + (gameScreenWidth / 2 - 100)), y, 20, yellow);
+            renderer.Text("Press Enter to play", (int)(screenX + (gameScreenWidth / 2 - 100)), y, 20, yellow);
             y += 30;
-            DrawText("Alt+Enter: toggle fullscreen", (int)(screenX + (gameScreenWidth / 2 - 120)), y, 20, yellow);
+            renderer.Text("Alt+Enter: toggle fullscreen", (int)(screenX + (gameScreenWidth / 2 - 120)), y, 20, yellow);
 #else
-            DrawText("- Press [P] or [ESC] to pause", (int)(screenX + (gameScreenWidth / 2 - 220)), y, 20, WHITE);
+            renderer.Text("- Press [P] or [ESC] to pause", (int)(screenX + (gameScreenWidth / 2 - 220)), y, 20, WHITE);
             y += 30;
-            DrawText("- Press [M] to toggle music", (int)(screenX + (gameScreenWidth / 2 - 220)), y, 20, WHITE);
+            renderer.Text("- Press [M] to toggle music", (int)(screenX + (gameScreenWidth / 2 - 220)), y, 20, WHITE);
             y += 70;
-            DrawText("Press Enter to play", (int)(screenX + (gameScreenWidth / 2 - 100)), y, 20, yellow);        
+            renderer.Text("Press Enter to play", (int)(screenX + (gameScreenWidth / 2 - 100)), y, 20, yellow);        
 #endif
         } else {
-            DrawText("- Tap to flap", (int)(screenX + (gameScreenWidth / 2 - 220)), y, 20, WHITE);
+            renderer.Text("- Tap to flap", (int)(screenX + (gameScreenWidth / 2 - 220)), y, 20, WHITE);
             y += 30;
-            DrawText("- Tap title bar to pause", (int)(screenX + (gameScreenWidth / 2 - 220)), y, 20, WHITE);  
+            renderer.Text("- Tap title bar to pause", (int)(screenX + (gameScreenWidth / 2 - 220)), y, 20, WHITE);  
             y += 70;
-            DrawText("Tap to play", (int)(screenX + (gameScreenWidth / 2 - 100)), y, 20, yellow);
+            renderer.Text("Tap to play", (int)(screenX + (gameScreenWidth / 2 - 100)), y, 20, yellow);
         }
     }
     else if (paused)
     {
-        DrawRectangleRounded({screenX + (float)(gameScreenWidth / 2 - 250), screenY + (float)(gameScreenHeight / 2 - 20), 500, 60}, 0.76f, 20, BLACK);
+        renderer.RectRounded({screenX + (float)(gameScreenWidth / 2 - 250), screenY + (float)(gameScreenHeight / 2 - 20), 500, 60}, 0.76f, 20, BLACK);
 #ifndef EMSCRIPTEN_BUILD
-        DrawText("Game paused, press P to continue", screenX + (gameScreenWidth / 2 - 200), screenY + gameScreenHeight / 2, 20, yellow);
+        renderer.Text("Game paused, press P to continue", screenX + (gameScreenWidth / 2 - 200), screenY + gameScreenHeight / 2, 20, yellow);
 #else
         if (isMobile) {
-            DrawText("Game paused, tap to continue", screenX + (gameScreenWidth / 2 - 200), screenY + gameScreenHeight / 2, 20, yellow);
+            renderer.Text("Game paused, tap to continue", screenX + (gameScreenWidth / 2 - 200), screenY + gameScreenHeight / 2, 20, yellow);
         } else {
-            DrawText("Game paused, press P or ESC to continue", screenX + (gameScreenWidth / 2 - 200), screenY + gameScreenHeight / 2, 20, yellow);
+            renderer.Text("Game paused, press P or ESC to continue", screenX + (gameScreenWidth / 2 - 200), screenY + gameScreenHeight / 2, 20, yellow);
         }
 #endif
     }
     else if (lostWindowFocus)
     {
-        DrawRectangleRounded({screenX + (float)(gameScreenWidth / 2 - 250), screenY + (float)(gameScreenHeight / 2 - 20), 500, 60}, 0.76f, 20, BLACK);
-        DrawText("Game paused, focus window to continue", screenX + (gameScreenWidth / 2 - 200), screenY + gameScreenHeight / 2, 20, yellow);
+        renderer.RectRounded({screenX + (float)(gameScreenWidth / 2 - 250), screenY + (float)(gameScreenHeight / 2 - 20), 500, 60}, 0.76f, 20, BLACK);
+        renderer.Text("Game paused, focus window to continue", screenX + (gameScreenWidth / 2 - 200), screenY + gameScreenHeight / 2, 20, yellow);
     }
     else if (gameOver)
     {
-        DrawRectangleRounded({screenX + (float)(gameScreenWidth / 2 - 250), screenY + (float)(gameScreenHeight / 2 - 20), 500, 100}, 0.76f, 20, BLACK);
-        std::string gameOverText = "Game Over! Score: " + std::to_string(score);
-        int gameOverTextWidth = MeasureText(gameOverText.c_str(), 20);
-        DrawText(gameOverText.c_str(), screenX + (gameScreenWidth / 2 - gameOverTextWidth/2), screenY + gameScreenHeight / 2 - 10, 20, yellow);
+        renderer.RectRounded({screenX + (float)(gameScreenWidth / 2 - 250), screenY + (float)(gameScreenHeight / 2 - 20), 500, 130}, 0.76f, 20, BLACK);
+        std::string gameOverText = (courseComplete ? "Course complete! Score: " : "Game Over! Score: ") + std::to_string(score);
+        if (playerCount > 1) {
+            // The last cat down wins; cats that crashed on the same tick are
+            // split by score
+            int winner = lastPlayerDown;
+            bool draw = false;
+            for (int i = 0; i < playerCount; i++) {
+                if (i == winner) continue;
+                if (playerDownTick[i] > playerDownTick[winner] ||
+                    (playerDownTick[i] == playerDownTick[winner] && playerScore[i] > playerScore[winner])) {
+                    winner = i;
+                    draw = false;
+                } else if (playerDownTick[i] == playerDownTick[winner] && playerScore[i] == playerScore[winner]) {
+                    draw = true;
+                }
+            }
+            gameOverText = draw ? "Draw! Score: " + std::to_string(playerScore[winner])
+                : "Player " + std::to_string(winner + 1) + " wins! Score: " + std::to_string(playerScore[winner]);
+        }
+        int gameOverTextWidth = renderer.TextWidth(gameOverText.c_str(), 20);
+        renderer.Text(gameOverText.c_str(), screenX + (gameScreenWidth / 2 - gameOverTextWidth/2), screenY + gameScreenHeight / 2 - 10, 20, yellow);
+        // Best score on this fixed seed, or in this mode or course
+        bool seedBoard = seedFixed && !courseMode;
+        uint32_t modeId = LeaderboardModeId(leaderboardMode);
+        const std::vector<LeaderboardRecord>& top = seedBoard ? leaderboard.Top(modeId, runSeed) : leaderboard.Top(modeId);
+        if (!top.empty()) {
+            std::string bestText = (courseMode ? "Course best: " : seedBoard ? "Best on seed " + std::to_string(runSeed) + ": " : "Best: ") + std::to_string(top[0].score);
+            int bestTextWidth = renderer.TextWidth(bestText.c_str(), 20);
+            renderer.Text(bestText.c_str(), screenX + (gameScreenWidth / 2 - bestTextWidth/2), screenY + gameScreenHeight / 2 + 20, 20, WHITE);
+        }
         if (isMobile) {
-            DrawText("Tap to play again", screenX + (gameScreenWidth / 2 - 100), screenY + gameScreenHeight / 2 + 30, 20, yellow);
+            renderer.Text("Tap to play again", screenX + (gameScreenWidth / 2 - 100), screenY + gameScreenHeight / 2 + 60, 20, yellow);
         } else {
-            DrawText("Press Enter to play again", screenX + (gameScreenWidth / 2 - 120), screenY + gameScreenHeight / 2 + 30, 20, yellow);
+            renderer.Text("Press Enter to play again", screenX + (gameScreenWidth / 2 - 120), screenY + gameScreenHeight / 2 + 60, 20, yellow);
         }
     }
 }
@@ -675,6 +851,121 @@ std::string Game::FormatWithLeadingZeroes(int number, int width)
 
 void Game::Randomize()
 {
+    // Pipe layouts come from raylib's generator, so a seed reproduces a run's
+    // course. Courses are authored and always recorded under seed 0.
+    runSeed = seedFixed ? fixedSeed : (unsigned int)time(nullptr) * 2654435761u + runNumber;
+    SetRandomSeed(runSeed);
+}
+
+void Game::OpenLeaderboard()
+{
+#ifdef __EMSCRIPTEN__
+    leaderboard.Open("/data/");
+#else
+    leaderboard.Open("");
+#endif
+    highScore = MAX(highScore, leaderboard.BestScore());
+    TraceLog(LOG_INFO, "LEADERBOARD: %llu runs, best %d",
+        (unsigned long long)leaderboard.RunCount(), leaderboard.BestScore());
+}
+
+void Game::SubmitRun()
+{
+    LeaderboardRecord record = {};
+    record.seed = courseMode ? 0 : runSeed;
+    record.mode = LeaderboardModeId(leaderboardMode);
+    record.score = score;
+    record.duration = runTime;
+    record.maxSpeed = runMaxSpeed;
+    record.runId = leaderboard.RunCount() + 1;
+    record.timestamp = (uint64_t)time(nullptr);
+    record.replayId = 0;
+    record.flags = seedFixed && !courseMode ? leaderboardFlagFixedSeed : 0;
+    if (inputLog.IsRecording()) {
+        std::string replayPath = captureName + "-" + std::to_string(record.runId) + ".input";
+        if (inputLog.Save(replayPath, score)) {
+            record.replayId = record.runId;
+        } else {
+            TraceLog(LOG_WARNING, "REPLAY: failed to write %s", replayPath.c_str());
+        }
+    }
+    leaderboard.Submit(record);
+}
+
+void Game::SetPlayerCount(int count)
+{
+    playerCount = MAX(1, MIN(count, maxPlayers));
+    for (int i = 0; i < maxPlayers; i++) {
+        playerY[i] = height / 2;
+        playerVelocity[i] = 0.0f;
+        playerAlive[i] = i < playerCount;
+        playerScore[i] = 0;
+        playerDownTick[i] = 0;
+        playerEyesClosedTimer[i] = 0.0f;
+    }
+    UpdateLeaderboardMode();
+}
+
+// Races are ranked apart from solo runs, per number of players
+void Game::UpdateLeaderboardMode()
+{
+    leaderboardMode = courseMode ? "course:" + courseName : "endless";
+    if (playerCount > 1) {
+        leaderboardMode += ":race" + std::to_string(playerCount);
+    }
+}
+
+bool Game::IsFlapPressed(int player) const
+{
+    // Solo play takes any of the usual controls; in a race each player has
+    // one key and one gamepad
+    if (playerCount == 1) {
+        return IsKeyPressed(KEY_SPACE) || IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_W)
+            || (isMobile && IsGestureDetected(GESTURE_TAP))
+            || IsGamepadButtonPressed(0, GAMEPAD_BUTTON_RIGHT_FACE_DOWN);
+    }
+    return IsKeyPressed(playerKeys[player]) || IsGamepadButtonPressed(player, GAMEPAD_BUTTON_RIGHT_FACE_DOWN);
+}
+
+bool Game::StartCapture(const std::string& name)
+{
+    recordInputs = capture.Start(name + ".y4m", gameScreenWidth, gameScreenHeight, captureFps);
+    captureName = name;
+    return recordInputs;
+}
+
+void Game::BeginInputLog()
+{
+    if (!recordInputs || replaying) return;
+    inputLog.Begin(courseMode ? 0 : runSeed, playerCount, leaderboardMode, pipeSpawnTimer, pipeSpawnInterval);
+}
+
+bool Game::LoadReplay(const std::string& path)
+{
+    if (!inputLog.Load(path)) {
+        TraceLog(LOG_WARNING, "REPLAY: failed to load %s", path.c_str());
+        return false;
+    }
+    const InputLogHeader& header = inputLog.Header();
+    SetPlayerCount((int)header.playerCount);
+    if (inputLog.Mode() != leaderboardMode) {
+        TraceLog(LOG_WARNING, "REPLAY: recorded in mode %s, playing in %s", inputLog.Mode().c_str(), leaderboardMode.c_str());
+    }
+
+    // Start the run straight away, in the state it was recorded in
+    firstTimeGameStart = false;
+    replaying = true;
+    runSeed = header.seed;
+    SetRandomSeed(runSeed);
+    pipeSpawnTimer = header.pipeSpawnTimer;
+    pipeSpawnInterval = header.pipeSpawnInterval;
+    if (!musicManuallyDisabled) {
+        PlayMusicStream(gameMusic);
+        musicPlaying = true;
+    }
+    LogEvent(ANALYTICS_RUN_START);
+    TraceLog(LOG_INFO, "REPLAY: %s, %u ticks, seed %u", path.c_str(), header.frameCount, header.seed);
+    return true;
 }
 
 void Game::LoadHighScore()
@@ -703,17 +994,165 @@ void Game::SaveHighScore()
 #endif
 }
 
+void Game::SpawnPipes(float dt)
+{
+    courseDistance += pipeSpeed * dt;
+
+    if (courseMode) {
+        // Spawn every course pipe whose left edge has reached the right screen edge
+        while (!course.Finished() && course.Peek().distance - courseDistance <= width) {
+            const CourseEntry& entry = course.Peek();
+            pipes.push_back({(float)(entry.distance - courseDistance), entry.pipe.gapCenter,
+                entry.pipe.gap, entry.pipe.width, entry.pipe.speed, false});
+            course.Advance();
+        }
+        return;
+    }
+
+    pipeSpawnTimer += dt;
+    if (pipeSpawnTimer >= pipeSpawnInterval) {
+        pipeSpawnTimer = 0.0f;
+        
+        // Calculate the target gap center based on the previous pipe
+        float targetGapCenter;
+        if (pipes.empty()) {
+            // First pipe - place it in the middle
+            targetGapCenter = height / 2;
+        } else {
+            // Get the previous pipe's gap center
+            float prevGapCenter = pipes.back().gapCenter;
+            
+            // Calculate the minimum and maximum allowed gap center
+            float minGapCenter = MAX(pipeGap/2, prevGapCenter - difficulty.maxGapHeightDifference);
+            float maxGapCenter = MIN(height - pipeGap/2, prevGapCenter + difficulty.maxGapHeightDifference);
+            
+            // Randomly choose a new gap center within the allowed range
+            targetGapCenter = GetRandomValue(minGapCenter, maxGapCenter);
+        }
+        
+        pipes.push_back({(float)width, targetGapCenter, pipeGap, pipeWidth, 0.0f, false});
+    }
+}
+
+bool Game::LoadCourse(const std::string& path)
+{
+    courseMode = course.Open(path);
+    if (courseMode) {
+        courseName = path.substr(path.find_last_of("/\\") + 1);
+        UpdateLeaderboardMode();
+        TraceLog(LOG_INFO, "COURSE: loaded %s (%u pipes)", path.c_str(), course.PipeCount());
+    } else {
+        TraceLog(LOG_WARNING, "COURSE: failed to load %s", path.c_str());
+    }
+    return courseMode;
+}
+
+void Game::UpdateParticles(float dt)
+{
+    if (particleStress) {
+        particles.FillForStress((float)width, (float)height);
+    }
+
+    double start = GetTime();
+    particles.Update(dt);
+    particleUpdateTime += GetTime() - start;
+    particleTimedFrames++;
+
+    particleReportTimer += dt;
+    if (particleStress && particleReportTimer >= 1.0) {
+        TraceLog(LOG_INFO, "PARTICLES: %d live, update %.3f ms, draw %.3f ms",
+            particles.Count(), particleUpdateTime * 1000.0 / particleTimedFrames,
+            particleDrawTime * 1000.0 / particleTimedFrames);
+        particleUpdateTime = 0.0;
+        particleDrawTime = 0.0;
+        particleTimedFrames = 0;
+        particleReportTimer = 0.0;
+    }
+}
+
+void Game::TriggerGameOver()
+{
+    gameOver = true;
+    gameOverDelayTimer = gameOverDelayDuration; // Initialize delay timer
+    // Stop the music and other sounds; KillPlayer already played the hit sound
+    StopMusicStream(gameMusic);
+    StopSound(flySound);
+    StopSound(scoreSound);
+    if (!courseComplete) {
+        postProcess.TriggerHitFlash();
+    }
+    if (score > highScore) {
+        highScore = score;
+        SaveHighScore();
+    }
+    // The run ends on its best cat, whose score is the run's score
+    int best = 0;
+    for (int i = 1; i < playerCount; i++) {
+        if (playerScore[i] > playerScore[best]) best = i;
+    }
+    LogEvent(ANALYTICS_RUN_END, best, courseComplete ? ANALYTICS_OUTCOME_COURSE_COMPLETE : ANALYTICS_OUTCOME_DEATH);
+    if (replaying) {
+        // A replayed run is already on the leaderboard
+        replaying = false;
+        TraceLog(LOG_INFO, "REPLAY: finished with score %d (recorded %d)", score, inputLog.Header().finalScore);
+    } else {
+        SubmitRun();
+    }
+}
+
+void Game::KillPlayer(int player)
+{
+    playerAlive[player] = false;
+    playerDownTick[player] = tick;
+    lastPlayerDown = player;
+    PlaySound(hitSound);
+    particles.EmitDebris(playerX, playerY[player], debrisCount);
+    LogEvent(ANALYTICS_DEATH, player);
+}
+
+void Game::LogEvent(AnalyticsEventType type, int player, AnalyticsRunOutcome outcome)
+{
+    AnalyticsEvent event;
+    event.type = type;
+    event.player = (uint8_t)player;
+    event.run = runNumber;
+    event.tick = tick;
+    event.score = playerScore[player];
+    event.x = playerX;
+    event.y = playerY[player];
+    event.velocity = playerVelocity[player];
+    event.pipeSpeed = pipeSpeed;
+    event.gapDelta = NextGapDelta(player);
+    event.outcome = outcome;
+    analytics.Record(event);
+}
+
+float Game::NextGapDelta(int player) const
+{
+    // The first pipe whose right edge is still ahead of the player's left edge
+    float collisionBoxWidth = playerSize * playerCollisionWidthRatio;
+    for (const auto& pipe : pipes) {
+        if (pipe.x + pipe.width > playerX - collisionBoxWidth/2) {
+            return playerY[player] - pipe.gapCenter;
+        }
+    }
+    return 0.0f;
+}
+
 void Game::UpdatePipeSpeed(float dt)
 {
-    pipeSpeed += pipeSpeedIncrease * dt;  // Smooth speed increase over time 
-    if (pipeSpeed > maxSpeed) {
-        pipeSpeed = maxSpeed;
+    if (!courseMode) {
+        pipeSpeed += difficulty.pipeSpeedIncrease * dt;  // Smooth speed increase over time 
+        if (pipeSpeed > difficulty.maxSpeed) {
+            pipeSpeed = difficulty.maxSpeed;
+        }
     }
     pipeSpawnInterval = initialPipeDistance / pipeSpeed; // Adjust spawn interval to maintain constant distance between pipes
-    backgroundScrollSpeed = pipeSpeed * 0.2f;  // Update background scroll speed to 20% of current pipe speed
     
     // Scale gravity and jump force with pipe speed
-    //float speedRatio = pipeSpeed / basePipeSpeed;  // How much faster we are compared to base speed
-    //gravity = defaultGravity * speedRatio;  // Scale gravity with speed
-    //jumpForce = defaultJumpForce * speedRatio;  // Scale jump force with speed
+    if (difficulty.scalePhysicsWithSpeed) {
+        float speedRatio = pipeSpeed / basePipeSpeed;  // How much faster we are compared to base speed
+        gravity = difficulty.gravity * speedRatio;  // Scale gravity with speed
+        jumpForce = difficulty.jumpForce * speedRatio;  // Scale jump force with speed
+    }
 }
\ No newline at end of file
@@ -4,10 +4,23 @@
 #include <vector>
 #include <fstream>
 #include "raylib.h"
+#include "analytics.h"
+#include "renderer.h"
+#include "particles.h"
+#include "difficulty.h"
+#include "course.h"
+#include "parallax.h"
+#include "leaderboard.h"
+#include "capture.h"
+#include "inputlog.h"
+#include "postprocess.h"
 
 struct Pipe {
     float x;
     float gapCenter;
+    float gap;
+    float width;
+    float speed;  // Speed zone starting once this pipe is passed, 0 for none
     bool scored;
 };
 
@@ -27,6 +40,27 @@ public:
     std::string FormatWithLeadingZeroes(int number, int width);
     void Randomize();
 
+    void SetRenderMode(RenderMode mode) { renderer.SetMode(mode); }
+    // Shows a high score of 0 whatever highscore.txt holds; the file is left alone
+    void IgnoreSavedHighScore() { highScore = 0; }
+    const Renderer& GetRenderer() const { return renderer; }
+    void SetParticleStress(bool enabled) { particleStress = enabled; }
+    // Play an authored .hcc course instead of random pipes
+    bool LoadCourse(const std::string& path);
+    // Play every run on the same seed instead of a fresh one per run
+    void SetSeed(unsigned int seed) { fixedSeed = seed; seedFixed = true; }
+    // Record the session to <name>.y4m and each run's inputs to <name>-<run id>.input
+    bool StartCapture(const std::string& name);
+    // Play a recorded run back from its input log
+    bool LoadReplay(const std::string& path);
+    // Local race: 1 to maxPlayers cats fly the same pipes in one view
+    void SetPlayerCount(int count);
+    // Effects fused into the final upscale, see PostEffect
+    void SetPostEffects(unsigned int effects) { postProcess.SetEffects(effects); }
+    // Logs the cost of each post effect over the given number of frames
+    void BenchmarkPostProcess(int frames);
+    static const int maxPlayers = 4;
+
     static bool isMobile;
 
 private:
@@ -35,9 +69,13 @@ private:
     bool paused;
     bool lostWindowFocus;
     bool gameOver;
+    bool courseComplete;  // The run ended by clearing the course's last pipe
 
     float screenScale;
     RenderTexture2D targetRenderTex;
+    PostProcess postProcess;
+    Rectangle ScreenRect() const;  // Where the game texture lands in the window
+    Renderer renderer;
     Font font;
 
     int width;
@@ -49,26 +87,56 @@ private:
     void LoadHighScore();
     void SaveHighScore();
 
+    // Run history and per-seed bests
+    Leaderboard leaderboard;
+    std::string leaderboardMode;  // "endless" or "course:<file>", plus ":race<n>" for races
+    std::string courseName;
+    void UpdateLeaderboardMode();
+    unsigned int runSeed;
+    unsigned int fixedSeed;
+    bool seedFixed;
+    float runTime;
+    float runMaxSpeed;
+    void OpenLeaderboard();
+    void SubmitRun();
+
+    // Video capture and deterministic input logs
+    FrameCapture capture;
+    const int captureFps = 60;
+    float frameTime;  // Game time covered by the frame being drawn, for capture pacing
+    std::string captureName;
+    InputLog inputLog;
+    bool recordInputs;
+    bool replaying;
+    uint32_t replayFlags;  // Recorded flaps for the current replay tick, bit per player
+    uint32_t flapped;      // Players that flapped this tick, for the input log
+    void BeginInputLog();
+
     float ballX;
     float ballY;
     int ballRadius;
     float ballSpeed;
     Color ballColor;
 
-    // Game variables
+    // Game variables, one entry per player. All cats share playerX so they
+    // meet every pipe at the same moment.
+    int playerCount;
     float playerX;
-    float playerY;
+    float playerY[maxPlayers];
     float playerSize;
-    float playerVelocity;
-    const float defaultGravity = 1200.0f;
-    const float defaultJumpForce = -400.0f;
+    float playerVelocity[maxPlayers];
+    bool playerAlive[maxPlayers];
+    int playerScore[maxPlayers];  // score holds the best of these
+    unsigned int playerDownTick[maxPlayers];  // Tick each cat went down, to rank a race
+    int lastPlayerDown;
+    const Color playerTint[maxPlayers] = { WHITE, { 150, 200, 255, 255 }, { 160, 255, 160, 255 }, { 255, 225, 120, 255 } };
+    const KeyboardKey playerKeys[maxPlayers] = { KEY_W, KEY_UP, KEY_I, KEY_KP_8 };
+    bool IsFlapPressed(int player) const;
+    void KillPlayer(int player);
+    const DifficultyParams difficulty;
     const float defaultPipeSpeed = 300.0f;
     const float defaultPipeSpawnInterval = 600.0f / defaultPipeSpeed;
     const float defaultPipeWidth = 80.0f;
-    const float defaultPipeGap = 230.0f;
-    const float pipeSpeedIncrease = 10.0f;  // Speed increase per second
-    const float maxGapHeightDifference = 100.0f;  // Maximum allowed vertical distance between consecutive pipe gaps
-    const float maxSpeed = 1200.0f;
     float gravity;
     float jumpForce;
     float pipeWidth;
@@ -81,6 +149,12 @@ private:
     float pipeSpawnTimer;
     float pipeSpawnInterval;
 
+    // Authored course, streamed a chunk at a time
+    CourseStream course;
+    bool courseMode;
+    double courseDistance;  // Distance scrolled since the run started
+    void SpawnPipes(float dt);
+
     // Sound variables
     Music gameMusic;
     Sound flySound;
@@ -90,15 +164,21 @@ private:
     bool musicManuallyDisabled;
 
     void UpdatePipeSpeed(float dt);  // Add function to update pipe speed
+    void TriggerGameOver();
+
+    // Gameplay analytics
+    AnalyticsLog analytics;
+    unsigned int runNumber;
+    unsigned int tick;  // Simulation frames since the run started
+    void LogEvent(AnalyticsEventType type, int player = 0, AnalyticsRunOutcome outcome = ANALYTICS_OUTCOME_NONE);
+    float NextGapDelta(int player) const;
 
     // Background scrolling
-    Texture2D backgroundTexture;
-    float backgroundScrollX;
-    float backgroundScrollSpeed;
+    ParallaxBackground background;
 
     Texture2D playerTexture;
     Texture2D playerTextureEyesClosed;
-    float playerEyesClosedTimer; // Time left to display eyes closed
+    float playerEyesClosedTimer[maxPlayers]; // Time left to display eyes closed
     const float playerEyesClosedDuration = 0.33f; // Duration in seconds
 
     float gameOverDelayTimer; // Time left before allowing input after game over
@@ -108,4 +188,17 @@ private:
     float playerCollisionHeightRatio;
 
     Texture2D pipeTexture;
+
+    // Flap feathers and crash debris
+    ParticleSystem particles;
+    Texture2D particleTexture;
+    const int featherCount = 12;
+    const int debrisCount = 80;
+    // Stress mode keeps the pool full and logs update/draw cost
+    bool particleStress;
+    double particleUpdateTime;
+    double particleDrawTime;
+    int particleTimedFrames;
+    double particleReportTimer;
+    void UpdateParticles(float dt);
 };
\ No newline at end of file
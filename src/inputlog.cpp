@@ -0,0 +1,77 @@
+#include <cstring>
+#include <fstream>
+
+#include "inputlog.h"
+
+InputLog::InputLog()
+{
+    header = {};
+    playbackIndex = 0;
+    recording = false;
+}
+
+void InputLog::Begin(uint32_t seed, uint32_t playerCount, const std::string& mode, float pipeSpawnTimer, float pipeSpawnInterval)
+{
+    header = {};
+    memcpy(header.magic, "HCIL", 4);
+    header.version = inputLogVersion;
+    header.seed = seed;
+    header.playerCount = playerCount;
+    header.pipeSpawnTimer = pipeSpawnTimer;
+    header.pipeSpawnInterval = pipeSpawnInterval;
+    strncpy(header.mode, mode.c_str(), sizeof(header.mode) - 1);
+    frames.clear();
+    playbackIndex = 0;
+    recording = true;
+}
+
+void InputLog::Record(float dt, uint32_t flags)
+{
+    if (!recording) return;
+    frames.push_back({dt, flags});
+}
+
+bool InputLog::Save(const std::string& path, int finalScore)
+{
+    recording = false;
+    header.finalScore = finalScore;
+    header.frameCount = (uint32_t)frames.size();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return false;
+    file.write((const char*)&header, sizeof(header));
+    file.write((const char*)frames.data(), sizeof(InputFrame) * frames.size());
+    return file.good();
+}
+
+bool InputLog::Load(const std::string& path)
+{
+    recording = false;
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    InputLogHeader fileHeader;
+    if (!file.read((char*)&fileHeader, sizeof(fileHeader))) return false;
+    if (memcmp(fileHeader.magic, "HCIL", 4) != 0 || fileHeader.version != inputLogVersion) return false;
+    fileHeader.mode[sizeof(fileHeader.mode) - 1] = '\0';
+
+    std::vector<InputFrame> fileFrames(fileHeader.frameCount);
+    if (!file.read((char*)fileFrames.data(), sizeof(InputFrame) * fileFrames.size())) return false;
+
+    header = fileHeader;
+    frames.swap(fileFrames);
+    playbackIndex = 0;
+    return true;
+}
+
+bool InputLog::Next(InputFrame& frame)
+{
+    if (recording || playbackIndex >= frames.size()) return false;
+    frame = frames[playbackIndex++];
+    return true;
+}
+
+std::string InputLog::Mode() const
+{
+    return std::string(header.mode, strnlen(header.mode, sizeof(header.mode)));
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Deterministic record of one run: the pipe seed and spawn timer state at the
+// start, then the frame time and flap input of every simulation tick. Feeding
+// the same ticks back through Game::Update reproduces the run exactly.
+
+struct InputFrame {
+    float dt;
+    uint32_t flags;         // Bit i set when player i flapped
+};
+
+struct InputLogHeader {
+    char magic[4];          // "HCIL"
+    uint32_t version;
+    uint32_t seed;
+    uint32_t playerCount;
+    float pipeSpawnTimer;
+    float pipeSpawnInterval;
+    int32_t finalScore;
+    uint32_t frameCount;
+    char mode[64];          // Leaderboard mode name, e.g. "endless"
+};
+
+const uint32_t inputLogVersion = 2;
+
+class InputLog
+{
+public:
+    InputLog();
+
+    void Begin(uint32_t seed, uint32_t playerCount, const std::string& mode, float pipeSpawnTimer, float pipeSpawnInterval);
+    void Record(float dt, uint32_t flags);
+    bool IsRecording() const { return recording; }
+    // Ends recording and writes the log; the run's final score is kept for
+    // checking a replay against it
+    bool Save(const std::string& path, int finalScore);
+
+    bool Load(const std::string& path);
+    // Next tick of a loaded log, false once all ticks have been played
+    bool Next(InputFrame& frame);
+
+    const InputLogHeader& Header() const { return header; }
+    std::string Mode() const;
+
+private:
+    InputLogHeader header;
+    std::vector<InputFrame> frames;
+    size_t playbackIndex;
+    bool recording;
+};
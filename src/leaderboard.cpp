@@ -0,0 +1,358 @@
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+
+#include "leaderboard.h"
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
+
+const uint32_t leaderboardSnapshotMagic = 0x5849434c;  // "LCIX"
+const uint32_t leaderboardSnapshotVersion = 2;
+
+uint32_t LeaderboardModeId(const std::string& mode)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (char c : mode) {
+        hash ^= (uint8_t)c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void LeaderboardMountStorage()
+{
+#ifdef __EMSCRIPTEN__
+    EM_ASM({
+        Module.hovercatStorageReady = 0;
+        FS.mkdir('/data');
+        FS.mount(IDBFS, {}, '/data');
+        FS.syncfs(true, function(err) { Module.hovercatStorageReady = 1; });
+    });
+#endif
+}
+
+bool LeaderboardStorageReady()
+{
+#ifdef __EMSCRIPTEN__
+    return EM_ASM_INT({ return Module.hovercatStorageReady | 0; }) != 0;
+#else
+    return true;
+#endif
+}
+
+Leaderboard::Leaderboard()
+{
+    opened = false;
+    bestScore = 0;
+    runCount = 0;
+    journalSize = 0;
+    recordsSinceSnapshot = 0;
+#ifdef __EMSCRIPTEN__
+    flushScheduled = false;
+#else
+    stopWorker = false;
+#endif
+}
+
+Leaderboard::~Leaderboard()
+{
+#ifndef __EMSCRIPTEN__
+    if (worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopWorker = true;
+        }
+        queueCondition.notify_one();
+        worker.join();
+    }
+#endif
+}
+
+void Leaderboard::InsertTop(TopList& top, const LeaderboardRecord& record)
+{
+    // Higher score first; an equal score ranks below the earlier run
+    auto position = std::upper_bound(top.begin(), top.end(), record,
+        [](const LeaderboardRecord& a, const LeaderboardRecord& b) { return a.score > b.score; });
+    if (position == top.end() && top.size() >= leaderboardTopCount) return;
+    top.insert(position, record);
+    if (top.size() > leaderboardTopCount) top.pop_back();
+}
+
+void Leaderboard::Insert(const LeaderboardRecord& record)
+{
+    InsertTop(modeBoards[Key(record.mode, 0)], record);
+    if (record.flags & leaderboardFlagFixedSeed) {
+        uint64_t key = Key(record.mode, record.seed);
+        auto it = seedBoards.find(key);
+        if (it != seedBoards.end()) {
+            InsertTop(it->second, record);
+        } else if (seedBoards.size() < leaderboardMaxSeedBoards) {
+            InsertTop(seedBoards[key], record);
+        }
+    }
+    runCount++;
+    bestScore = std::max(bestScore, (int)record.score);
+}
+
+const std::vector<LeaderboardRecord>& Leaderboard::Top(uint32_t mode) const
+{
+    auto it = modeBoards.find(Key(mode, 0));
+    return it != modeBoards.end() ? it->second : empty;
+}
+
+const std::vector<LeaderboardRecord>& Leaderboard::Top(uint32_t mode, uint32_t seed) const
+{
+    auto it = seedBoards.find(Key(mode, seed));
+    return it != seedBoards.end() ? it->second : empty;
+}
+
+void Leaderboard::Open(const std::string& directory)
+{
+    journalPath = directory + "leaderboard.log";
+    snapshotPath = directory + "leaderboard.idx";
+
+    uint64_t journalOffset = 0;
+    if (!LoadSnapshot(journalOffset)) {
+        modeBoards.clear();
+        seedBoards.clear();
+        runCount = 0;
+        bestScore = 0;
+        journalOffset = 0;
+    }
+    LoadJournal(journalOffset);
+
+    journal.open(journalPath, std::ios::binary | std::ios::app);
+    opened = true;
+
+#ifndef __EMSCRIPTEN__
+    worker = std::thread(&Leaderboard::WorkerLoop, this);
+#endif
+}
+
+bool Leaderboard::LoadSnapshot(uint64_t& journalOffset)
+{
+    std::ifstream file(snapshotPath, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t runs = 0;
+    int32_t best = 0;
+    file.read((char*)&magic, sizeof(magic));
+    file.read((char*)&version, sizeof(version));
+    file.read((char*)&journalOffset, sizeof(journalOffset));
+    file.read((char*)&runs, sizeof(runs));
+    file.read((char*)&best, sizeof(best));
+    if (!file || magic != leaderboardSnapshotMagic || version != leaderboardSnapshotVersion) return false;
+
+    // A snapshot that covers more than the journal holds is from another journal
+    std::ifstream journal(journalPath, std::ios::binary | std::ios::ate);
+    uint64_t journalFileSize = journal.is_open() ? (uint64_t)journal.tellg() : 0;
+    if (journalOffset > journalFileSize) return false;
+
+    if (!LoadBoards(file, modeBoards) || !LoadBoards(file, seedBoards)) return false;
+    runCount = runs;
+    bestScore = best;
+    journalSize = journalOffset;
+    return true;
+}
+
+bool Leaderboard::LoadBoards(std::ifstream& file, Index& boards)
+{
+    uint32_t keyCount = 0;
+    file.read((char*)&keyCount, sizeof(keyCount));
+    if (!file) return false;
+    boards.reserve(keyCount);
+    for (uint32_t k = 0; k < keyCount; k++) {
+        uint64_t key = 0;
+        uint32_t count = 0;
+        file.read((char*)&key, sizeof(key));
+        file.read((char*)&count, sizeof(count));
+        if (!file || count == 0 || count > leaderboardTopCount) return false;
+        TopList top(count);
+        file.read((char*)top.data(), sizeof(LeaderboardRecord) * count);
+        if (!file) return false;
+        boards[key] = std::move(top);
+    }
+    return true;
+}
+
+void Leaderboard::LoadJournal(uint64_t journalOffset)
+{
+    std::ifstream file(journalPath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        journalSize = 0;
+        return;
+    }
+    uint64_t size = (uint64_t)file.tellg();
+    journalSize = size;
+    if (size <= journalOffset) return;
+
+    std::vector<char> tail((size_t)(size - journalOffset));
+    file.seekg((std::streamoff)journalOffset);
+    file.read(tail.data(), tail.size());
+
+    // A torn write leaves a partial record; skip forward to the next magic
+    size_t pos = 0;
+    while (pos + sizeof(LeaderboardRecord) <= tail.size()) {
+        LeaderboardRecord record;
+        memcpy(&record, &tail[pos], sizeof(record));
+        if (record.magic != leaderboardRecordMagic) {
+            pos++;
+            continue;
+        }
+        Insert(record);
+        recordsSinceSnapshot++;
+        pos += sizeof(record);
+    }
+}
+
+void Leaderboard::Submit(const LeaderboardRecord& submitted)
+{
+    if (!opened) return;
+    LeaderboardRecord record = submitted;
+    record.magic = leaderboardRecordMagic;
+    record.reserved = 0;
+
+#ifndef __EMSCRIPTEN__
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        Insert(record);
+        pending.push_back(record);
+    }
+    queueCondition.notify_one();
+#else
+    // The append is one small write to the in-memory file system; compaction
+    // and the IndexedDB sync wait until the browser gets control back
+    Insert(record);
+    Store(record);
+    if (!flushScheduled) {
+        flushScheduled = true;
+        emscripten_async_call(&Leaderboard::FlushStorage, this, 0);
+    }
+#endif
+}
+
+void Leaderboard::Store(const LeaderboardRecord& record)
+{
+    if (journal.is_open()) {
+        journal.write((const char*)&record, sizeof(record));
+        journal.flush();
+        journalSize += sizeof(record);
+    }
+    recordsSinceSnapshot++;
+}
+
+#ifdef __EMSCRIPTEN__
+static void PersistStorage()
+{
+    // Writes go to the in-memory file system; this copies them to IndexedDB
+    // in the background
+    EM_ASM({ FS.syncfs(false, function(err) {}); });
+}
+
+void Leaderboard::FlushStorage(void* leaderboard)
+{
+    Leaderboard* self = (Leaderboard*)leaderboard;
+    self->flushScheduled = false;
+    if (self->recordsSinceSnapshot >= compactAfterRecords) {
+        self->WriteSnapshot();
+    }
+    PersistStorage();
+}
+#endif
+
+static void AppendBytes(std::vector<char>& out, const void* data, size_t size)
+{
+    out.insert(out.end(), (const char*)data, (const char*)data + size);
+}
+
+static void AppendBoards(std::vector<char>& out, const std::unordered_map<uint64_t, std::vector<LeaderboardRecord>>& boards)
+{
+    uint32_t keyCount = (uint32_t)boards.size();
+    AppendBytes(out, &keyCount, sizeof(keyCount));
+    for (const auto& entry : boards) {
+        uint32_t count = (uint32_t)entry.second.size();
+        AppendBytes(out, &entry.first, sizeof(entry.first));
+        AppendBytes(out, &count, sizeof(count));
+        AppendBytes(out, entry.second.data(), sizeof(LeaderboardRecord) * count);
+    }
+}
+
+void Leaderboard::WriteSnapshot()
+{
+    // The index is bounded, so it is serialized to memory in one go and the
+    // file is written outside the lock
+    std::vector<char> snapshot;
+    {
+#ifndef __EMSCRIPTEN__
+        // Queued runs are already in the index; journal them first so the
+        // snapshot covers exactly what the journal holds
+        std::lock_guard<std::mutex> lock(queueMutex);
+        while (!pending.empty()) {
+            Store(pending.front());
+            pending.pop_front();
+        }
+        uint64_t journalOffset = journalSize;
+#else
+        // IndexedDB stores whole files, so the web journal restarts once the
+        // snapshot holds its runs
+        uint64_t journalOffset = 0;
+#endif
+        int32_t best = bestScore;
+        AppendBytes(snapshot, &leaderboardSnapshotMagic, sizeof(leaderboardSnapshotMagic));
+        AppendBytes(snapshot, &leaderboardSnapshotVersion, sizeof(leaderboardSnapshotVersion));
+        AppendBytes(snapshot, &journalOffset, sizeof(journalOffset));
+        AppendBytes(snapshot, &runCount, sizeof(runCount));
+        AppendBytes(snapshot, &best, sizeof(best));
+        AppendBoards(snapshot, modeBoards);
+        AppendBoards(snapshot, seedBoards);
+    }
+
+    std::string tempPath = snapshotPath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return;
+        file.write(snapshot.data(), snapshot.size());
+        if (!file.good()) return;
+    }
+    // Replace the old snapshot only once the new one is complete
+    std::remove(snapshotPath.c_str());
+    if (std::rename(tempPath.c_str(), snapshotPath.c_str()) != 0) return;
+    recordsSinceSnapshot = 0;
+#ifdef __EMSCRIPTEN__
+    journal.close();
+    journal.open(journalPath, std::ios::binary | std::ios::trunc);
+    journalSize = 0;
+#endif
+}
+
+#ifndef __EMSCRIPTEN__
+void Leaderboard::WorkerLoop()
+{
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (true) {
+        queueCondition.wait(lock, [this] { return stopWorker || !pending.empty(); });
+        if (pending.empty()) break;
+
+        LeaderboardRecord record = pending.front();
+        pending.pop_front();
+        lock.unlock();
+        Store(record);
+        if (recordsSinceSnapshot >= compactAfterRecords) {
+            WriteSnapshot();
+        }
+        lock.lock();
+    }
+    lock.unlock();
+
+    // Leave a snapshot covering the whole journal so the next start reads no tail
+    if (recordsSinceSnapshot > 0) {
+        WriteSnapshot();
+    }
+}
+#endif
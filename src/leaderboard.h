@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <fstream>
+#ifndef __EMSCRIPTEN__
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+// Local score store. Every finished run is appended to a journal
+// (leaderboard.log); an in-memory index keeps the top scores per mode, and per
+// seed for runs on a seed the player picked. Random seeds share their mode's
+// board, so the index stays a few kilobytes however many runs are played. The
+// index is periodically compacted into a snapshot (leaderboard.idx) that
+// records how much of the journal it covers, so startup reads the snapshot and
+// only the journal tail. Journal appends and compaction run on a worker
+// thread; on the web they run between frames, the files live in IDBFS, and
+// the journal restarts after each compaction so syncs stay small.
+
+struct LeaderboardRecord {
+    uint32_t magic;
+    uint32_t seed;
+    uint32_t mode;        // LeaderboardModeId() of the mode name
+    int32_t score;
+    float duration;       // Seconds
+    float maxSpeed;
+    uint64_t runId;
+    uint64_t timestamp;   // Unix seconds
+    uint64_t replayId;    // Input log reference, 0 if the run was not recorded
+    uint32_t flags;
+    uint32_t reserved;    // Zero; keeps the record a multiple of 8 bytes
+};
+
+const uint32_t leaderboardRecordMagic = 0x4252434c;  // "LCRB"
+const uint32_t leaderboardFlagFixedSeed = 1;         // Seed set with --seed; also ranked on its own board
+const size_t leaderboardTopCount = 10;
+const size_t leaderboardMaxSeedBoards = 64;         // Further fixed seeds only rank on the mode board
+
+uint32_t LeaderboardModeId(const std::string& mode);
+
+// Web builds keep the leaderboard in IndexedDB. Mount once at startup and
+// open the leaderboard after LeaderboardStorageReady() turns true.
+void LeaderboardMountStorage();
+bool LeaderboardStorageReady();
+
+class Leaderboard
+{
+public:
+    Leaderboard();
+    ~Leaderboard();
+    // Loads the snapshot plus the journal tail from directory (may be empty)
+    void Open(const std::string& directory);
+    bool IsOpen() const { return opened; }
+
+    // Inserts into the index immediately and queues the journal append
+    void Submit(const LeaderboardRecord& record);
+    // Best runs in a mode, or on one fixed seed of a mode
+    const std::vector<LeaderboardRecord>& Top(uint32_t mode) const;
+    const std::vector<LeaderboardRecord>& Top(uint32_t mode, uint32_t seed) const;
+    int BestScore() const { return bestScore; }
+    uint64_t RunCount() const { return runCount; }
+
+private:
+    typedef std::vector<LeaderboardRecord> TopList;
+    typedef std::unordered_map<uint64_t, TopList> Index;
+
+    static uint64_t Key(uint32_t mode, uint32_t seed) { return ((uint64_t)mode << 32) | seed; }
+    void Insert(const LeaderboardRecord& record);
+    static void InsertTop(TopList& top, const LeaderboardRecord& record);
+    bool LoadSnapshot(uint64_t& journalOffset);
+    bool LoadBoards(std::ifstream& file, Index& boards);
+    void LoadJournal(uint64_t journalOffset);
+    void Store(const LeaderboardRecord& record);
+    void WriteSnapshot();
+
+    static const int compactAfterRecords = 256;
+
+    std::string journalPath;
+    std::string snapshotPath;
+    bool opened;
+    Index modeBoards;   // Keyed by mode alone
+    Index seedBoards;   // Fixed seeds, keyed by mode and seed
+    TopList empty;
+    int bestScore;
+    uint64_t runCount;
+
+    // Storage side, owned by the worker thread once it runs. The game thread
+    // changes the index only under queueMutex, which compaction holds while
+    // it serializes the index.
+    std::ofstream journal;
+    uint64_t journalSize;
+    int recordsSinceSnapshot;
+
+#ifdef __EMSCRIPTEN__
+    static void FlushStorage(void* leaderboard);
+    bool flushScheduled;
+#else
+    void WorkerLoop();
+
+    std::thread worker;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::deque<LeaderboardRecord> pending;
+    bool stopWorker;
+#endif
+};
@@ -2,21 +2,115 @@
 #include "globals.h"
 #include "game.h"
 #include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <string>
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
 #endif
 
 Game* game = nullptr;
 
+#ifdef HOVERCAT_FRAME_STATS
+// Average/worst Update+Draw time and average frame interval, logged every
+// few seconds so different builds can be compared in the browser console
+struct FrameStats {
+    double workSum = 0.0;
+    double workMax = 0.0;
+    double dtSum = 0.0;
+    int frames = 0;
+};
+FrameStats frameStats;
+const double frameStatsInterval = 5.0;
+#endif
+
 void mainLoop()
 {
     float dt = GetFrameTime();
+#ifdef HOVERCAT_FRAME_STATS
+    double workStart = GetTime();
+#endif
     game->Update(dt);
     game->Draw();
+    if (game->GetRenderer().GetMode() != RENDER_IMMEDIATE) {
+        static double lastRenderReport = 0.0;
+        if (GetTime() - lastRenderReport >= 1.0) {
+            const RenderStats& stats = game->GetRenderer().Stats();
+            TraceLog(LOG_INFO, "RENDER: %d draw calls, %d texture switches, overdraw %.2fx",
+                stats.drawCalls, stats.textureSwitches, stats.overdraw);
+            lastRenderReport = GetTime();
+        }
+    }
+#ifdef HOVERCAT_FRAME_STATS
+    double work = GetTime() - workStart;
+    frameStats.workSum += work;
+    frameStats.workMax = MAX(frameStats.workMax, work);
+    frameStats.dtSum += dt;
+    frameStats.frames++;
+    if (frameStats.dtSum >= frameStatsInterval) {
+        TraceLog(LOG_INFO, "FRAME: avg %.3f ms, max %.3f ms, frame interval %.3f ms (%d frames)",
+            frameStats.workSum * 1000.0 / frameStats.frames, frameStats.workMax * 1000.0,
+            frameStats.dtSum * 1000.0 / frameStats.frames, frameStats.frames);
+        frameStats = FrameStats();
+    }
+#endif
 }
 
-int main()
+int main(int argc, char** argv)
 {
+    // --render-stats: record draw commands and log per-frame render stats
+    // --render-golden <file>: render the title screen once, compare its
+    //   command list to <file> and exit with the result
+    // --update-golden: with --render-golden, rewrite <file> instead
+    // --particle-stress: keep 100k particles alive and log their update/draw cost
+    // --course <file.hcc>: play an authored course
+    // --seed <n>: play every run on pipe seed n
+    // --capture <name>: record video to <name>.y4m and each run's inputs to
+    //   <name>-<run id>.input
+    // --replay <file.input>: play a recorded run back
+    // --players <n>: local race for 2-4 players on the same course
+    // --post <off|low|medium|high>: post effects quality tier
+    // --crt: add the CRT filter to the post effects
+    // --post-bench: log the cost of each post effect and exit
+    bool renderStats = false;
+    std::string coursePath;
+    bool particleStress = false;
+    long long seed = -1;
+    std::string captureName;
+    std::string replayPath;
+    int players = 1;
+    unsigned int postEffects = 0;
+    bool postBench = false;
+    std::string renderGolden;
+    bool updateGolden = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--render-stats") == 0) {
+            renderStats = true;
+        } else if (strcmp(argv[i], "--render-golden") == 0 && i + 1 < argc) {
+            renderGolden = argv[++i];
+        } else if (strcmp(argv[i], "--update-golden") == 0) {
+            updateGolden = true;
+        } else if (strcmp(argv[i], "--particle-stress") == 0) {
+            particleStress = true;
+        } else if (strcmp(argv[i], "--course") == 0 && i + 1 < argc) {
+            coursePath = argv[++i];
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoll(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc) {
+            captureName = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (strcmp(argv[i], "--players") == 0 && i + 1 < argc) {
+            players = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--post") == 0 && i + 1 < argc) {
+            postEffects |= PostQualityEffects(PostQualityFromName(argv[++i]));
+        } else if (strcmp(argv[i], "--crt") == 0) {
+            postEffects |= POST_CRT;
+        } else if (strcmp(argv[i], "--post-bench") == 0) {
+            postBench = true;
+        }
+    }
+
     InitWindow(gameScreenWidth, gameScreenHeight, "Hovercat");
 #ifndef EMSCRIPTEN_BUILD
     SetWindowState(FLAG_WINDOW_RESIZABLE);
@@ -26,8 +120,43 @@ int main()
     SetTargetFPS(144);
     
     game = new Game(gameScreenWidth, gameScreenHeight);
+    game->SetPlayerCount(players);
+    if (seed >= 0) {
+        game->SetSeed((unsigned int)seed);
+    }
     game->Randomize();
 
+    if (!renderGolden.empty()) {
+        // The golden must not depend on the working directory's highscore.txt
+        game->IgnoreSavedHighScore();
+        game->SetRenderMode(RENDER_RECORD_ONLY);
+        game->Draw();
+        bool match = game->GetRenderer().CheckGolden(renderGolden, updateGolden);
+        delete game;
+        CloseWindow();
+        return match ? 0 : 1;
+    }
+    if (postBench) {
+        game->BenchmarkPostProcess(300);
+        delete game;
+        CloseWindow();
+        return 0;
+    }
+    game->SetPostEffects(postEffects);
+    if (renderStats) {
+        game->SetRenderMode(RENDER_RECORD);
+    }
+    game->SetParticleStress(particleStress);
+    if (!coursePath.empty()) {
+        game->LoadCourse(coursePath);
+    }
+    if (!captureName.empty()) {
+        game->StartCapture(captureName);
+    }
+    if (!replayPath.empty()) {
+        game->LoadReplay(replayPath);
+    }
+
 #ifdef __EMSCRIPTEN__
     emscripten_set_main_loop(mainLoop, 0, 1);
 #else
@@ -0,0 +1,196 @@
+#include <cmath>
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "globals.h"
+#include "parallax.h"
+
+// Layers are sampled with fract() instead of REPEAT wrap, which WebGL 1
+// does not support on the non power of two sky texture
+#if defined(PLATFORM_WEB)
+static const char* parallaxFragmentShader = R"(#version 100
+precision mediump float;
+varying vec2 fragTexCoord;
+varying vec4 fragColor;
+uniform sampler2D texture0;
+uniform sampler2D hillsTexture;
+uniform sampler2D groundTexture;
+uniform vec3 layerOffset;
+uniform vec3 layerScale;
+void main()
+{
+    vec2 uv = fragTexCoord;
+    vec4 color = texture2D(texture0, vec2(fract(layerOffset.x + uv.x * layerScale.x), uv.y));
+    vec4 hills = texture2D(hillsTexture, vec2(fract(layerOffset.y + uv.x * layerScale.y), uv.y));
+    color.rgb = mix(color.rgb, hills.rgb, hills.a);
+    vec4 ground = texture2D(groundTexture, vec2(fract(layerOffset.z + uv.x * layerScale.z), uv.y));
+    color.rgb = mix(color.rgb, ground.rgb, ground.a);
+    gl_FragColor = vec4(color.rgb, 1.0) * fragColor;
+}
+)";
+#else
+static const char* parallaxFragmentShader = R"(#version 330
+in vec2 fragTexCoord;
+in vec4 fragColor;
+uniform sampler2D texture0;
+uniform sampler2D hillsTexture;
+uniform sampler2D groundTexture;
+uniform vec3 layerOffset;
+uniform vec3 layerScale;
+out vec4 finalColor;
+void main()
+{
+    vec2 uv = fragTexCoord;
+    vec4 color = texture(texture0, vec2(fract(layerOffset.x + uv.x * layerScale.x), uv.y));
+    vec4 hills = texture(hillsTexture, vec2(fract(layerOffset.y + uv.x * layerScale.y), uv.y));
+    color.rgb = mix(color.rgb, hills.rgb, hills.a);
+    vec4 ground = texture(groundTexture, vec2(fract(layerOffset.z + uv.x * layerScale.z), uv.y));
+    color.rgb = mix(color.rgb, ground.rgb, ground.a);
+    finalColor = vec4(color.rgb, 1.0) * fragColor;
+}
+)";
+#endif
+
+// Silhouette of rolling hills. Only whole sine periods across the width are
+// used so the texture tiles without a seam.
+static Texture2D GenerateHills(int width, int height)
+{
+    Image image = GenImageColor(width, height, BLANK);
+    Color* pixels = (Color*)image.data;
+    for (int x = 0; x < width; x++) {
+        float t = 2.0f * PI * x / width;
+        float ridge = height * 0.72f - 40.0f * sinf(2.0f * t) - 22.0f * sinf(5.0f * t + 1.3f) - 9.0f * sinf(11.0f * t + 0.4f);
+        for (int y = (int)ridge; y < height; y++) {
+            if (y < 0) continue;
+            float depth = (y - ridge) / (height - ridge);
+            pixels[y * width + x] = Color{ (unsigned char)(70 - 30 * depth), (unsigned char)(120 - 40 * depth), (unsigned char)(110 - 20 * depth), 140 };
+        }
+    }
+    Texture2D texture = LoadTextureFromImage(image);
+    UnloadImage(image);
+    SetTextureFilter(texture, TEXTURE_FILTER_BILINEAR);
+    return texture;
+}
+
+// Grass band along the bottom edge with tufts that repeat across the width
+static Texture2D GenerateGround(int width, int height)
+{
+    Image image = GenImageColor(width, height, BLANK);
+    Color* pixels = (Color*)image.data;
+    const int bandHeight = 26;
+    for (int x = 0; x < width; x++) {
+        float t = 2.0f * PI * x / width;
+        int tuft = (int)(4.0f + 3.0f * sinf(32.0f * t) + 2.0f * sinf(77.0f * t));
+        for (int y = height - bandHeight - tuft; y < height; y++) {
+            bool stripe = ((x / 16) % 2) == 0;
+            unsigned char green = (unsigned char)(stripe ? 150 : 135);
+            pixels[y * width + x] = Color{ 60, green, 50, 255 };
+        }
+    }
+    Texture2D texture = LoadTextureFromImage(image);
+    UnloadImage(image);
+    SetTextureFilter(texture, TEXTURE_FILTER_BILINEAR);
+    return texture;
+}
+
+ParallaxBackground::ParallaxBackground()
+{
+    screenWidth = 0;
+    screenHeight = 0;
+    shader = {};
+    shaderLoaded = false;
+    offsetLoc = -1;
+    scaleLoc = -1;
+    hillsLoc = -1;
+    groundLoc = -1;
+    for (int i = 0; i < layerCount; i++) {
+        layers[i] = {};
+        scroll[i] = 0.0;
+    }
+}
+
+void ParallaxBackground::Load(int screenWidth, int screenHeight)
+{
+    this->screenWidth = screenWidth;
+    this->screenHeight = screenHeight;
+
+    layers[0] = LoadTexture("Data/background.jpg");
+    layers[1] = GenerateHills(1024, screenHeight);
+    layers[2] = GenerateGround(512, screenHeight);
+
+    shader = LoadShaderFromMemory(nullptr, parallaxFragmentShader);
+    // raylib falls back to its default shader when compilation fails
+    shaderLoaded = shader.id != rlGetShaderIdDefault();
+    if (shaderLoaded) {
+        offsetLoc = GetShaderLocation(shader, "layerOffset");
+        scaleLoc = GetShaderLocation(shader, "layerScale");
+        hillsLoc = GetShaderLocation(shader, "hillsTexture");
+        groundLoc = GetShaderLocation(shader, "groundTexture");
+    } else {
+        TraceLog(LOG_WARNING, "PARALLAX: shader failed to compile, drawing layers separately");
+    }
+}
+
+void ParallaxBackground::Unload()
+{
+    for (int i = 0; i < layerCount; i++) {
+        UnloadTexture(layers[i]);
+    }
+    if (shaderLoaded) {
+        UnloadShader(shader);
+    }
+}
+
+void ParallaxBackground::Update(float dt, float pipeSpeed)
+{
+    for (int i = 0; i < layerCount; i++) {
+        scroll[i] = fmod(scroll[i] + (double)pipeSpeed * speedFactor[i] * dt, (double)layers[i].width);
+    }
+}
+
+void ParallaxBackground::Draw(Renderer& renderer)
+{
+    if (!shaderLoaded) {
+        DrawFallback(renderer);
+        return;
+    }
+
+    // Offsets in texture widths; the scale maps screen width to the part of
+    // each layer visible at once (all layers are screen height)
+    float offset[layerCount];
+    float scale[layerCount];
+    for (int i = 0; i < layerCount; i++) {
+        offset[i] = (float)(scroll[i] / layers[i].width);
+        scale[i] = (float)screenWidth / layers[i].width;
+    }
+    SetShaderValue(shader, offsetLoc, offset, SHADER_UNIFORM_VEC3);
+    SetShaderValue(shader, scaleLoc, scale, SHADER_UNIFORM_VEC3);
+
+    RenderShaderPass pass = {};
+    pass.shader = shader;
+    pass.samplerCount = 2;
+    pass.samplerLoc[0] = hillsLoc;
+    pass.sampler[0] = layers[1];
+    pass.samplerLoc[1] = groundLoc;
+    pass.sampler[1] = layers[2];
+    renderer.ShaderQuad(pass, layers[0],
+        { 0, 0, (float)layers[0].width, (float)layers[0].height },
+        { 0, 0, (float)screenWidth, (float)screenHeight }, WHITE);
+}
+
+// Wraparound quads per layer, as before the shader existed
+void ParallaxBackground::DrawFallback(Renderer& renderer)
+{
+    for (int i = 0; i < layerCount; i++) {
+        const Texture2D& texture = layers[i];
+        if (texture.width <= 0) continue;
+        float srcX = (float)scroll[i];
+        float x = 0.0f;
+        while (x < screenWidth) {
+            float part = MIN(texture.width - srcX, screenWidth - x);
+            renderer.Texture(texture, { srcX, 0, part, (float)screenHeight }, { x, 0, part, (float)screenHeight }, WHITE);
+            x += part;
+            srcX = 0.0f;
+        }
+    }
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "raylib.h"
+#include "renderer.h"
+
+// Layered scrolling background: sky (Data/background.jpg), far hills and near
+// ground, each scrolling at its own fraction of the pipe speed. All layers
+// are composited by one fragment shader on a single fullscreen quad.
+// Scroll offsets are doubles wrapped to their texture width every frame, so
+// they stay exact however long a run lasts.
+class ParallaxBackground
+{
+public:
+    static const int layerCount = 3;
+
+    ParallaxBackground();
+    void Load(int screenWidth, int screenHeight);
+    void Unload();
+    void Update(float dt, float pipeSpeed);
+    void Draw(Renderer& renderer);
+
+private:
+    void DrawFallback(Renderer& renderer);
+
+    int screenWidth;
+    int screenHeight;
+    Texture2D layers[layerCount];
+    double scroll[layerCount];          // Pixels, wrapped to the layer width
+    const float speedFactor[layerCount] = { 0.2f, 0.45f, 1.0f };
+
+    Shader shader;
+    bool shaderLoaded;
+    int offsetLoc;
+    int scaleLoc;
+    int hillsLoc;
+    int groundLoc;
+};
@@ -0,0 +1,138 @@
+#include <cmath>
+
+#include "raylib.h"
+#include "globals.h"
+#include "particles.h"
+#include "renderer.h"
+
+ParticleSystem::ParticleSystem()
+{
+    count = 0;
+    rngState = 0x9e3779b9u;
+    posX.resize(capacity);
+    posY.resize(capacity);
+    velX.resize(capacity);
+    velY.resize(capacity);
+    life.resize(capacity);
+    invMaxLife.resize(capacity);
+    size.resize(capacity);
+    baseColor.resize(capacity);
+    drawColor.resize(capacity);
+}
+
+void ParticleSystem::Clear()
+{
+    count = 0;
+}
+
+float ParticleSystem::RandomRange(float min, float max)
+{
+    // xorshift32, kept separate from raylib's generator so effects don't
+    // change the pipe sequence
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return min + (max - min) * (rngState >> 8) * (1.0f / 16777216.0f);
+}
+
+void ParticleSystem::Emit(float x, float y, float vx, float vy, float lifetime, float particleSize, Color color)
+{
+    if (count >= capacity) return;
+    int i = count++;
+    posX[i] = x;
+    posY[i] = y;
+    velX[i] = vx;
+    velY[i] = vy;
+    life[i] = lifetime;
+    invMaxLife[i] = 1.0f / lifetime;
+    size[i] = particleSize;
+    baseColor[i] = color;
+    drawColor[i] = color;
+}
+
+void ParticleSystem::EmitFeathers(float x, float y, int amount)
+{
+    for (int i = 0; i < amount; i++) {
+        unsigned char shade = (unsigned char)RandomRange(200.0f, 255.0f);
+        Emit(x + RandomRange(-12.0f, 4.0f), y + RandomRange(-6.0f, 18.0f),
+            RandomRange(-160.0f, -40.0f), RandomRange(20.0f, 140.0f),
+            RandomRange(0.35f, 0.7f), RandomRange(4.0f, 8.0f),
+            Color{ shade, shade, shade, 230 });
+    }
+}
+
+void ParticleSystem::EmitDebris(float x, float y, int amount)
+{
+    for (int i = 0; i < amount; i++) {
+        float angle = RandomRange(0.0f, 2.0f * PI);
+        float speed = RandomRange(120.0f, 420.0f);
+        unsigned char red = (unsigned char)RandomRange(170.0f, 240.0f);
+        Emit(x, y, cosf(angle) * speed, sinf(angle) * speed - 150.0f,
+            RandomRange(0.6f, 1.2f), RandomRange(5.0f, 11.0f),
+            Color{ red, (unsigned char)(red / 4), 40, 255 });
+    }
+}
+
+void ParticleSystem::FillForStress(float width, float height)
+{
+    while (count < capacity) {
+        Emit(RandomRange(0.0f, width), RandomRange(0.0f, height),
+            RandomRange(-200.0f, 200.0f), RandomRange(-300.0f, 0.0f),
+            RandomRange(0.5f, 2.0f), RandomRange(2.0f, 6.0f),
+            Color{ 255, 255, 255, 160 });
+    }
+}
+
+void ParticleSystem::Update(float dt)
+{
+    if (count == 0) return;
+
+    // Integrate: straight loops over the arrays with no branches so they vectorize
+    float dragFactor = powf(drag, dt * 60.0f);
+    float gravityStep = gravity * dt;
+    float* px = posX.data();
+    float* py = posY.data();
+    float* vx = velX.data();
+    float* vy = velY.data();
+    float* remaining = life.data();
+    for (int i = 0; i < count; i++) {
+        vx[i] *= dragFactor;
+        vy[i] = vy[i] * dragFactor + gravityStep;
+        px[i] += vx[i] * dt;
+        py[i] += vy[i] * dt;
+        remaining[i] -= dt;
+    }
+
+    // Cull: one pass over the live particles that moves the last one into
+    // each dead slot. The check is O(count), but only deaths copy anything
+    // and the live ones stay packed without shifting
+    int i = 0;
+    while (i < count) {
+        if (remaining[i] > 0.0f) {
+            i++;
+            continue;
+        }
+        int last = --count;
+        posX[i] = posX[last];
+        posY[i] = posY[last];
+        velX[i] = velX[last];
+        velY[i] = velY[last];
+        life[i] = life[last];
+        invMaxLife[i] = invMaxLife[last];
+        size[i] = size[last];
+        baseColor[i] = baseColor[last];
+    }
+
+    // Fade with remaining life
+    for (int i = 0; i < count; i++) {
+        float fade = MIN(1.0f, remaining[i] * invMaxLife[i] * 2.0f);
+        drawColor[i] = baseColor[i];
+        drawColor[i].a = (unsigned char)(baseColor[i].a * fade);
+    }
+}
+
+void ParticleSystem::Draw(Renderer& renderer, Texture2D texture) const
+{
+    if (count == 0) return;
+    renderer.Quads(texture, posX.data(), posY.data(), size.data(), drawColor.data(), count);
+}
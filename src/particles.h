@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "raylib.h"
+
+class Renderer;
+
+// Fixed-capacity particle pool stored as structure of arrays. Storage is
+// allocated once up front; emitting past capacity drops particles. Update
+// integrates every particle in flat loops the compiler can vectorize, then
+// removes dead ones by swapping in the last particle. All particles draw as
+// one quad batch.
+class ParticleSystem
+{
+public:
+    static const int capacity = 100000;
+
+    ParticleSystem();
+    void Clear();
+    void EmitFeathers(float x, float y, int count);
+    void EmitDebris(float x, float y, int count);
+    void FillForStress(float width, float height);
+    void Update(float dt);
+    void Draw(Renderer& renderer, Texture2D texture) const;
+    int Count() const { return count; }
+
+private:
+    void Emit(float x, float y, float vx, float vy, float life, float size, Color color);
+    float RandomRange(float min, float max);
+
+    int count;
+    uint32_t rngState;
+
+    // Structure of arrays, all sized to capacity
+    std::vector<float> posX;
+    std::vector<float> posY;
+    std::vector<float> velX;
+    std::vector<float> velY;
+    std::vector<float> life;
+    std::vector<float> invMaxLife;
+    std::vector<float> size;
+    std::vector<Color> baseColor;
+    std::vector<Color> drawColor;  // baseColor faded by remaining life
+
+    const float gravity = 600.0f;
+    const float drag = 0.98f;  // Velocity kept per 1/60 s
+};
@@ -0,0 +1,181 @@
+#include <string>
+#include <cstring>
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "globals.h"
+#include "postprocess.h"
+
+// One source for both GLSL versions; each effect is switched in with a define
+#if defined(PLATFORM_WEB)
+static const char* postShaderPrefix = R"(#version 100
+precision mediump float;
+#define IN varying
+#define TEX texture2D
+#define OUT gl_FragColor
+)";
+#else
+static const char* postShaderPrefix = R"(#version 330
+#define IN in
+#define TEX texture
+out vec4 finalColor;
+#define OUT finalColor
+)";
+#endif
+
+static const char* postShaderBody = R"(
+IN vec2 fragTexCoord;
+IN vec4 fragColor;
+uniform sampler2D texture0;
+uniform vec2 texelSize;
+uniform float sharpenAmount;
+uniform float vignetteAmount;
+uniform float blurAmount;       // Blur length in source texels
+uniform float flashAmount;
+uniform float crtAmount;
+void main()
+{
+    vec2 uv = fragTexCoord;
+#ifdef CRT
+    vec2 centered = uv * 2.0 - 1.0;
+    centered *= 1.0 + crtAmount * 0.06 * dot(centered, centered);
+    uv = centered * 0.5 + 0.5;
+#endif
+    vec3 color = TEX(texture0, uv).rgb;
+#ifdef SHARPEN
+    vec3 neighbors = TEX(texture0, uv + vec2(texelSize.x, 0.0)).rgb + TEX(texture0, uv - vec2(texelSize.x, 0.0)).rgb
+        + TEX(texture0, uv + vec2(0.0, texelSize.y)).rgb + TEX(texture0, uv - vec2(0.0, texelSize.y)).rgb;
+    color += sharpenAmount * (color - neighbors * 0.25);
+#endif
+#ifdef MOTION_BLUR
+    // The world scrolls left, so things smear to the right of where they are
+    vec3 blur = color;
+    for (int i = 1; i <= 4; i++) {
+        blur += TEX(texture0, uv + vec2(texelSize.x * blurAmount * float(i) * 0.25, 0.0)).rgb;
+    }
+    color = blur * 0.2;
+#endif
+#ifdef HIT_FLASH
+    color = mix(color, vec3(1.0), flashAmount);
+#endif
+#ifdef VIGNETTE
+    vec2 offset = fragTexCoord - 0.5;
+    color *= 1.0 - vignetteAmount * smoothstep(0.1, 0.5, dot(offset, offset));
+#endif
+#ifdef CRT
+    // Darken the boundary between source rows; black outside the curved screen
+    float scan = 0.5 + 0.5 * cos(uv.y / texelSize.y * 6.2831853);
+    color *= 1.0 - crtAmount * 0.3 * scan;
+    if (uv.x < 0.0 || uv.x > 1.0 || uv.y < 0.0 || uv.y > 1.0) color = vec3(0.0);
+#endif
+    OUT = vec4(clamp(color, 0.0, 1.0), 1.0) * fragColor;
+}
+)";
+
+unsigned int PostQualityEffects(PostQuality quality)
+{
+    switch (quality) {
+        case POST_QUALITY_LOW: return POST_VIGNETTE | POST_HIT_FLASH;
+        case POST_QUALITY_MEDIUM: return POST_VIGNETTE | POST_HIT_FLASH | POST_SHARPEN;
+        case POST_QUALITY_HIGH: return POST_VIGNETTE | POST_HIT_FLASH | POST_SHARPEN | POST_MOTION_BLUR;
+        default: return 0;
+    }
+}
+
+PostQuality PostQualityFromName(const char* name)
+{
+    if (strcmp(name, "low") == 0) return POST_QUALITY_LOW;
+    if (strcmp(name, "medium") == 0) return POST_QUALITY_MEDIUM;
+    if (strcmp(name, "high") == 0) return POST_QUALITY_HIGH;
+    return POST_QUALITY_OFF;
+}
+
+PostProcess::PostProcess()
+{
+    for (unsigned int i = 0; i < POST_EFFECT_COMBINATIONS; i++) {
+        variants[i] = {};
+        variants[i].compiled = false;
+        variants[i].failed = false;
+    }
+    effects = 0;
+    speedFactor = 0.0f;
+    flash = 0.0f;
+}
+
+void PostProcess::Unload()
+{
+    for (unsigned int i = 0; i < POST_EFFECT_COMBINATIONS; i++) {
+        if (variants[i].compiled) {
+            UnloadShader(variants[i].shader);
+            variants[i].compiled = false;
+        }
+    }
+}
+
+void PostProcess::SetEffects(unsigned int effects)
+{
+    this->effects = effects & (POST_EFFECT_COMBINATIONS - 1);
+    if (this->effects != 0) {
+        Compile(this->effects);
+    }
+}
+
+void PostProcess::Compile(unsigned int effects)
+{
+    Variant& variant = variants[effects];
+    if (variant.compiled || variant.failed) return;
+
+    std::string source = postShaderPrefix;
+    if (effects & POST_SHARPEN) source += "#define SHARPEN\n";
+    if (effects & POST_VIGNETTE) source += "#define VIGNETTE\n";
+    if (effects & POST_MOTION_BLUR) source += "#define MOTION_BLUR\n";
+    if (effects & POST_HIT_FLASH) source += "#define HIT_FLASH\n";
+    if (effects & POST_CRT) source += "#define CRT\n";
+    source += postShaderBody;
+
+    variant.shader = LoadShaderFromMemory(nullptr, source.c_str());
+    // raylib falls back to its default shader when compilation fails
+    if (variant.shader.id == rlGetShaderIdDefault()) {
+        TraceLog(LOG_WARNING, "POSTFX: effect set 0x%02x failed to compile, using the plain upscale", effects);
+        variant.failed = true;
+        return;
+    }
+    variant.compiled = true;
+    variant.texelSizeLoc = GetShaderLocation(variant.shader, "texelSize");
+    variant.sharpenLoc = GetShaderLocation(variant.shader, "sharpenAmount");
+    variant.vignetteLoc = GetShaderLocation(variant.shader, "vignetteAmount");
+    variant.blurLoc = GetShaderLocation(variant.shader, "blurAmount");
+    variant.flashLoc = GetShaderLocation(variant.shader, "flashAmount");
+    variant.crtLoc = GetShaderLocation(variant.shader, "crtAmount");
+}
+
+void PostProcess::Update(float dt, float speedFactor)
+{
+    this->speedFactor = MAX(0.0f, MIN(speedFactor, 1.0f));
+    if (flash > 0.0f) {
+        flash = MAX(0.0f, flash - dt / flashDuration);
+    }
+}
+
+void PostProcess::Draw(const Texture2D& source, Rectangle sourceRect, Rectangle destRect)
+{
+    const Variant& variant = variants[effects];
+    if (effects == 0 || !variant.compiled) {
+        DrawTexturePro(source, sourceRect, destRect, (Vector2){0, 0}, 0.0f, WHITE);
+        return;
+    }
+
+    // Uniforms the variant compiled out have location -1 and are skipped
+    float texelSize[2] = { 1.0f / source.width, 1.0f / source.height };
+    float blur = maxBlurTexels * speedFactor;
+    SetShaderValue(variant.shader, variant.texelSizeLoc, texelSize, SHADER_UNIFORM_VEC2);
+    SetShaderValue(variant.shader, variant.sharpenLoc, &sharpenAmount, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(variant.shader, variant.vignetteLoc, &vignetteAmount, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(variant.shader, variant.blurLoc, &blur, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(variant.shader, variant.flashLoc, &flash, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(variant.shader, variant.crtLoc, &crtAmount, SHADER_UNIFORM_FLOAT);
+
+    BeginShaderMode(variant.shader);
+    DrawTexturePro(source, sourceRect, destRect, (Vector2){0, 0}, 0.0f, WHITE);
+    EndShaderMode();
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "raylib.h"
+
+// Effects applied while the game texture is upscaled to the window. They are
+// all fused into the one fullscreen draw that did the plain upscale, so they
+// add no render targets or passes. Each combination of effects is its own
+// shader variant, compiled the first time it is selected, so a disabled
+// effect costs nothing.
+
+enum PostEffect : unsigned int {
+    POST_SHARPEN = 1 << 0,      // Unsharp mask on the bilinear upscale
+    POST_VIGNETTE = 1 << 1,
+    POST_MOTION_BLUR = 1 << 2,  // Horizontal smear that grows with pipe speed
+    POST_HIT_FLASH = 1 << 3,    // White flash on game over
+    POST_CRT = 1 << 4,          // Barrel distortion and scanlines
+    POST_EFFECT_COMBINATIONS = 1 << 5
+};
+
+enum PostQuality {
+    POST_QUALITY_OFF = 0,
+    POST_QUALITY_LOW,       // Vignette and hit flash, one texture sample
+    POST_QUALITY_MEDIUM,    // Adds sharpening, five samples
+    POST_QUALITY_HIGH       // Adds motion blur, nine samples
+};
+
+unsigned int PostQualityEffects(PostQuality quality);
+// "off", "low", "medium" or "high"; anything else is off
+PostQuality PostQualityFromName(const char* name);
+
+class PostProcess
+{
+public:
+    PostProcess();
+    void Unload();
+
+    // Selects the active effects, compiling their variant if needed
+    void SetEffects(unsigned int effects);
+    unsigned int Effects() const { return effects; }
+
+    // speedFactor is 0 at the starting pipe speed and 1 at the maximum
+    void Update(float dt, float speedFactor);
+    void TriggerHitFlash() { flash = 1.0f; }
+
+    // The fused upscale: draws source to dest on the current target
+    void Draw(const Texture2D& source, Rectangle sourceRect, Rectangle destRect);
+
+private:
+    struct Variant {
+        Shader shader;
+        bool compiled;
+        bool failed;
+        int texelSizeLoc;
+        int sharpenLoc;
+        int vignetteLoc;
+        int blurLoc;
+        int flashLoc;
+        int crtLoc;
+    };
+
+    void Compile(unsigned int effects);
+
+    Variant variants[POST_EFFECT_COMBINATIONS];
+    unsigned int effects;
+    float speedFactor;
+    float flash;
+
+    const float sharpenAmount = 0.6f;
+    const float vignetteAmount = 0.35f;
+    const float maxBlurTexels = 3.0f;
+    const float flashDuration = 0.25f;  // Seconds to fade from white
+    const float crtAmount = 1.0f;
+};
@@ -0,0 +1,305 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "globals.h"
+#include "renderer.h"
+
+Renderer::Renderer()
+{
+    mode = RENDER_IMMEDIATE;
+    stats = {};
+    lastTexture = 0;
+    screenArea = 1.0f;
+    screenRect = {0, 0, 0, 0};
+    commands.reserve(1024);
+    textPool.reserve(4096);
+}
+
+void Renderer::SetMode(RenderMode mode)
+{
+    this->mode = mode;
+}
+
+void Renderer::BeginFrame(int screenWidth, int screenHeight)
+{
+    commands.clear();
+    textPool.clear();
+    quadBatches.clear();
+    shaderPasses.clear();
+    stats = {};
+    lastTexture = 0;
+    screenRect = {0, 0, (float)screenWidth, (float)screenHeight};
+    screenArea = MAX(1.0f, (float)screenWidth * screenHeight);
+}
+
+void Renderer::EndFrame()
+{
+    stats.overdraw = stats.drawnArea / screenArea;
+    if (mode == RENDER_RECORD) {
+        for (const auto& command : commands) {
+            Execute(command);
+        }
+    }
+}
+
+uint16_t Renderer::TextureIndex(Texture2D texture)
+{
+    for (size_t i = 0; i < textures.size(); i++) {
+        if (textures[i].id == texture.id) return (uint16_t)i;
+    }
+    textures.push_back(texture);
+    return (uint16_t)(textures.size() - 1);
+}
+
+void Renderer::Push(const RenderCommand& command, float area)
+{
+    stats.drawCalls++;
+    if (stats.drawCalls == 1 || command.texture != lastTexture) {
+        stats.textureSwitches++;
+        lastTexture = command.texture;
+    }
+    stats.drawnArea += area;
+
+    if (mode == RENDER_IMMEDIATE) {
+        Execute(command);
+    } else {
+        commands.push_back(command);
+    }
+}
+
+// Area of rec that falls inside the screen
+static float VisibleArea(Rectangle rec, Rectangle screen)
+{
+    float x0 = MAX(rec.x, screen.x);
+    float y0 = MAX(rec.y, screen.y);
+    float x1 = MIN(rec.x + rec.width, screen.x + screen.width);
+    float y1 = MIN(rec.y + rec.height, screen.y + screen.height);
+    if (x1 <= x0 || y1 <= y0) return 0.0f;
+    return (x1 - x0) * (y1 - y0);
+}
+
+void Renderer::Texture(Texture2D texture, Rectangle src, Rectangle dst, Color tint)
+{
+    RenderCommand command = {};
+    command.type = RENDER_CMD_TEXTURE;
+    command.texture = TextureIndex(texture);
+    command.src = src;
+    command.dst = dst;
+    command.color = tint;
+    Push(command, VisibleArea(dst, screenRect));
+}
+
+void Renderer::Rect(int x, int y, int width, int height, Color color)
+{
+    RenderCommand command = {};
+    command.type = RENDER_CMD_RECT;
+    command.texture = shapesTexture;
+    command.dst = {(float)x, (float)y, (float)width, (float)height};
+    command.color = color;
+    Push(command, VisibleArea(command.dst, screenRect));
+}
+
+void Renderer::RectLines(int x, int y, int width, int height, Color color)
+{
+    RenderCommand command = {};
+    command.type = RENDER_CMD_RECT_LINES;
+    command.texture = shapesTexture;
+    command.dst = {(float)x, (float)y, (float)width, (float)height};
+    command.color = color;
+    Push(command, 0.0f);
+}
+
+void Renderer::RectRounded(Rectangle rec, float roundness, int segments, Color color)
+{
+    RenderCommand command = {};
+    command.type = RENDER_CMD_RECT_ROUNDED;
+    command.texture = shapesTexture;
+    command.fontSize = (uint16_t)segments;
+    command.src = {roundness, 0, 0, 0};
+    command.dst = rec;
+    command.color = color;
+    Push(command, VisibleArea(rec, screenRect));
+}
+
+void Renderer::Text(const char* text, int x, int y, int fontSize, Color color)
+{
+    RenderCommand command = {};
+    command.type = RENDER_CMD_TEXT;
+    command.texture = fontTexture;
+    command.fontSize = (uint16_t)fontSize;
+    command.dst = {(float)x, (float)y, 0, (float)fontSize};
+    command.color = color;
+    command.textOffset = (uint32_t)textPool.size();
+    textPool.append(text);
+    textPool.push_back('\0');
+    command.dst.width = (float)TextWidth(text, fontSize);
+    Push(command, VisibleArea(command.dst, screenRect));
+}
+
+int Renderer::TextWidth(const char* text, int fontSize) const
+{
+    // Only measured when there is a font to measure with
+    return mode != RENDER_RECORD_ONLY ? MeasureText(text, fontSize) : 0;
+}
+
+void Renderer::Quads(Texture2D texture, const float* x, const float* y, const float* size, const Color* color, int count)
+{
+    RenderCommand command = {};
+    command.type = RENDER_CMD_QUADS;
+    command.texture = TextureIndex(texture);
+    command.textOffset = (uint32_t)quadBatches.size();
+    quadBatches.push_back({ x, y, size, color, count });
+
+    float area = 0.0f;
+    for (int i = 0; i < count; i++) {
+        area += size[i] * size[i];
+    }
+    command.dst = {0, 0, (float)count, 0};
+    Push(command, area);
+}
+
+void Renderer::ShaderQuad(const RenderShaderPass& pass, Texture2D texture, Rectangle src, Rectangle dst, Color tint)
+{
+    RenderCommand command = {};
+    command.type = RENDER_CMD_SHADER_QUAD;
+    command.texture = TextureIndex(texture);
+    command.src = src;
+    command.dst = dst;
+    command.color = tint;
+    command.textOffset = (uint32_t)shaderPasses.size();
+    shaderPasses.push_back(pass);
+    Push(command, VisibleArea(dst, screenRect));
+}
+
+// Quads go straight to rlgl: one texture bind, vertices streamed into the
+// active batch, which raylib only flushes when its vertex buffer fills up
+static void ExecuteQuads(Texture2D texture, const RenderQuadBatch& batch)
+{
+    const int quadsPerChunk = 2048;
+    for (int start = 0; start < batch.count; start += quadsPerChunk) {
+        int end = MIN(batch.count, start + quadsPerChunk);
+        rlCheckRenderBatchLimit((end - start) * 4);
+        rlSetTexture(texture.id);
+        rlBegin(RL_QUADS);
+        for (int i = start; i < end; i++) {
+            float half = batch.size[i] * 0.5f;
+            float left = batch.x[i] - half;
+            float top = batch.y[i] - half;
+            float right = batch.x[i] + half;
+            float bottom = batch.y[i] + half;
+            Color c = batch.color[i];
+            rlColor4ub(c.r, c.g, c.b, c.a);
+            rlTexCoord2f(0.0f, 0.0f);
+            rlVertex2f(left, top);
+            rlTexCoord2f(0.0f, 1.0f);
+            rlVertex2f(left, bottom);
+            rlTexCoord2f(1.0f, 1.0f);
+            rlVertex2f(right, bottom);
+            rlTexCoord2f(1.0f, 0.0f);
+            rlVertex2f(right, top);
+        }
+        rlEnd();
+        rlSetTexture(0);
+    }
+}
+
+void Renderer::Execute(const RenderCommand& command) const
+{
+    switch (command.type) {
+    case RENDER_CMD_TEXTURE:
+        DrawTexturePro(textures[command.texture], command.src, command.dst, {0, 0}, 0.0f, command.color);
+        break;
+    case RENDER_CMD_RECT:
+        DrawRectangle((int)command.dst.x, (int)command.dst.y, (int)command.dst.width, (int)command.dst.height, command.color);
+        break;
+    case RENDER_CMD_RECT_LINES:
+        DrawRectangleLines((int)command.dst.x, (int)command.dst.y, (int)command.dst.width, (int)command.dst.height, command.color);
+        break;
+    case RENDER_CMD_RECT_ROUNDED:
+        DrawRectangleRounded(command.dst, command.src.x, command.fontSize, command.color);
+        break;
+    case RENDER_CMD_TEXT:
+        DrawText(&textPool[command.textOffset], (int)command.dst.x, (int)command.dst.y, command.fontSize, command.color);
+        break;
+    case RENDER_CMD_QUADS:
+        ExecuteQuads(textures[command.texture], quadBatches[command.textOffset]);
+        break;
+    case RENDER_CMD_SHADER_QUAD: {
+        const RenderShaderPass& pass = shaderPasses[command.textOffset];
+        BeginShaderMode(pass.shader);
+        for (int i = 0; i < pass.samplerCount; i++) {
+            SetShaderValueTexture(pass.shader, pass.samplerLoc[i], pass.sampler[i]);
+        }
+        DrawTexturePro(textures[command.texture], command.src, command.dst, {0, 0}, 0.0f, command.color);
+        EndShaderMode();
+        break;
+    }
+    }
+}
+
+std::string Renderer::Serialize() const
+{
+    static const char* names[] = { "texture", "rect", "rect_lines", "rect_rounded", "text", "quads", "shader_quad" };
+    std::string out;
+    char line[256];
+    for (const auto& command : commands) {
+        std::string texture;
+        if (command.texture == shapesTexture) texture = "shapes";
+        else if (command.texture == fontTexture) texture = "font";
+        else texture = std::to_string(textures[command.texture].width) + "x" + std::to_string(textures[command.texture].height);
+
+        snprintf(line, sizeof(line), "%s %s src %.1f %.1f %.1f %.1f dst %.1f %.1f %.1f %.1f color %d %d %d %d",
+            names[command.type], texture.c_str(),
+            command.src.x, command.src.y, command.src.width, command.src.height,
+            command.dst.x, command.dst.y, command.dst.width, command.dst.height,
+            command.color.r, command.color.g, command.color.b, command.color.a);
+        out += line;
+        if (command.type == RENDER_CMD_TEXT) {
+            out += " \"";
+            out += &textPool[command.textOffset];
+            out += "\"";
+        }
+        out += "\n";
+    }
+    return out;
+}
+
+bool Renderer::CheckGolden(const std::string& path, bool update) const
+{
+    std::string current = Serialize();
+    if (update) {
+        std::ofstream out(path);
+        out << current;
+        if (!out.good()) {
+            TraceLog(LOG_ERROR, "RENDER: cannot write golden file %s", path.c_str());
+            return false;
+        }
+        TraceLog(LOG_INFO, "RENDER: wrote golden file %s (%d commands)", path.c_str(), (int)commands.size());
+        return true;
+    }
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        TraceLog(LOG_ERROR, "RENDER: golden file %s is missing; create it with --update-golden", path.c_str());
+        return false;
+    }
+
+    std::istringstream actual(current);
+    std::string expectedLine;
+    std::string actualLine;
+    int lineNumber = 0;
+    while (true) {
+        bool haveExpected = (bool)std::getline(in, expectedLine);
+        bool haveActual = (bool)std::getline(actual, actualLine);
+        lineNumber++;
+        if (!haveExpected && !haveActual) return true;
+        if (haveExpected != haveActual || expectedLine != actualLine) {
+            TraceLog(LOG_ERROR, "RENDER: golden mismatch in %s at command %d", path.c_str(), lineNumber);
+            TraceLog(LOG_ERROR, "RENDER:   expected: %s", haveExpected ? expectedLine.c_str() : "<end>");
+            TraceLog(LOG_ERROR, "RENDER:   actual:   %s", haveActual ? actualLine.c_str() : "<end>");
+            return false;
+        }
+    }
+}
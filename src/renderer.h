@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "raylib.h"
+
+// Thin layer over the raylib Draw* calls used by Game. In immediate mode it
+// forwards straight to raylib. In record mode every call is stored as a
+// compact command and replayed at EndFrame, so per-frame draw call counts,
+// texture switches and overdraw can be measured and the command list diffed
+// against a golden file. RENDER_RECORD_ONLY skips the replay for headless runs.
+
+enum RenderMode {
+    RENDER_IMMEDIATE = 0,
+    RENDER_RECORD,
+    RENDER_RECORD_ONLY
+};
+
+enum RenderCommandType : uint8_t {
+    RENDER_CMD_TEXTURE = 0,
+    RENDER_CMD_RECT,
+    RENDER_CMD_RECT_LINES,
+    RENDER_CMD_RECT_ROUNDED,
+    RENDER_CMD_TEXT,
+    RENDER_CMD_QUADS,
+    RENDER_CMD_SHADER_QUAD
+};
+
+struct RenderCommand {
+    uint8_t type;
+    uint16_t texture;     // Index into the renderer's texture table
+    uint16_t fontSize;    // Text size, or segments for rounded rectangles
+    Rectangle src;        // Source rect; x holds roundness for rounded rectangles
+    Rectangle dst;
+    Color color;
+    uint32_t textOffset;  // Into the text pool, NUL terminated, or the quad batch / shader pass index
+};
+
+// Centered square sprites sharing one texture, drawn in a single batch. The
+// arrays are borrowed and must stay valid until EndFrame.
+struct RenderQuadBatch {
+    const float* x;
+    const float* y;
+    const float* size;
+    const Color* color;
+    int count;
+};
+
+// One textured quad drawn with a custom shader. Extra sampler textures are
+// bound at execution time, after the shader is enabled.
+struct RenderShaderPass {
+    Shader shader;
+    int samplerCount;
+    int samplerLoc[2];
+    Texture2D sampler[2];
+};
+
+struct RenderStats {
+    int drawCalls;
+    int textureSwitches;
+    float drawnArea;      // Sum of on-screen destination areas
+    float overdraw;       // drawnArea / screen area
+};
+
+class Renderer
+{
+public:
+    Renderer();
+    void SetMode(RenderMode mode);
+    RenderMode GetMode() const { return mode; }
+    void BeginFrame(int screenWidth, int screenHeight);
+    void EndFrame();
+
+    void Texture(Texture2D texture, Rectangle src, Rectangle dst, Color tint);
+    void Rect(int x, int y, int width, int height, Color color);
+    void RectLines(int x, int y, int width, int height, Color color);
+    void RectRounded(Rectangle rec, float roundness, int segments, Color color);
+    void Text(const char* text, int x, int y, int fontSize, Color color);
+    // MeasureText for layout. 0 in RENDER_RECORD_ONLY, so golden files do not
+    // depend on the font.
+    int TextWidth(const char* text, int fontSize) const;
+    void Quads(Texture2D texture, const float* x, const float* y, const float* size, const Color* color, int count);
+    void ShaderQuad(const RenderShaderPass& pass, Texture2D texture, Rectangle src, Rectangle dst, Color tint);
+
+    const RenderStats& Stats() const { return stats; }
+    // One command per line, stable across runs for golden comparisons
+    std::string Serialize() const;
+    // Compares against the golden file, or rewrites it when update is set.
+    // Returns false and logs the first differing line on mismatch, or when the
+    // file is missing and update is not set.
+    bool CheckGolden(const std::string& path, bool update) const;
+
+private:
+    void Push(const RenderCommand& command, float area);
+    void Execute(const RenderCommand& command) const;
+    uint16_t TextureIndex(Texture2D texture);
+
+    // Shapes and the default font are batched against raylib's own textures
+    static const uint16_t shapesTexture = 0xfffe;
+    static const uint16_t fontTexture = 0xffff;
+
+    RenderMode mode;
+    std::vector<RenderCommand> commands;
+    std::vector<Texture2D> textures;
+    std::string textPool;
+    std::vector<RenderQuadBatch> quadBatches;
+    std::vector<RenderShaderPass> shaderPasses;
+    RenderStats stats;
+    uint16_t lastTexture;
+    float screenArea;
+    Rectangle screenRect;
+};
@@ -0,0 +1,251 @@
+// Offline aggregation of analytics.bin files written by the game.
+//
+// Usage: analytics_query [--csv] <analytics.bin>...
+//
+// Prints per build: run length, score and flap percentiles, a death heatmap
+// (next pipe index vs. distance from the gap center) and deaths by pipe speed.
+// A run ends on its ANALYTICS_RUN_END event, whether a death or a completed
+// course ended it; logs older than format 3 have none, so there a run ends on
+// its last cat's death. A race scores as its best cat; flaps and deaths are
+// counted per cat.
+
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <algorithm>
+#include <fstream>
+
+#include "../src/analytics.h"
+
+struct RunStats {
+    std::vector<uint32_t> flaps;  // Per player
+    std::vector<bool> down;
+    uint32_t pauses = 0;
+    bool legacy = false;     // Read from a log without ANALYTICS_RUN_END
+    bool died = false;
+    uint32_t lastDeathTick = 0;
+    int32_t bestScore = 0;
+    bool ended = false;
+    uint32_t endTick = 0;
+    int32_t endScore = 0;
+    uint8_t outcome = ANALYTICS_OUTCOME_NONE;
+};
+
+struct BuildStats {
+    std::unordered_map<uint64_t, RunStats> runs;
+    std::vector<uint32_t> runTicks;
+    std::vector<int32_t> runScores;
+    size_t coursesCompleted = 0;
+    std::vector<uint32_t> runFlaps;
+    std::vector<int32_t> deathPipe;
+    std::vector<float> deathGapDelta;
+    std::vector<float> deathSpeed;
+    uint64_t events = 0;
+};
+
+const int heatmapPipeBuckets = 12;      // Pipes 0..9, then 10..19, then 20+
+const int heatmapGapBuckets = 12;
+const float heatmapGapMin = -150.0f;
+const float heatmapGapStep = 25.0f;
+const float speedBucketSize = 100.0f;
+
+static uint64_t RunKey(uint64_t sessionId, uint32_t run)
+{
+    return sessionId * 0x9E3779B97F4A7C15ull ^ run;
+}
+
+template <typename T>
+static T Percentile(std::vector<T>& values, double p)
+{
+    if (values.empty()) return T();
+    size_t index = (size_t)std::min((double)values.size() - 1, std::floor(p * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+static int PipeBucket(int32_t pipe)
+{
+    if (pipe < 10) return pipe;
+    if (pipe < 20) return 10;
+    return 11;
+}
+
+static std::string PipeBucketLabel(int bucket)
+{
+    if (bucket < 10) return "pipe " + std::to_string(bucket);
+    if (bucket == 10) return "10-19";
+    return "20+";
+}
+
+static int GapBucket(float gapDelta)
+{
+    int bucket = (int)std::floor((gapDelta - heatmapGapMin) / heatmapGapStep);
+    return std::max(0, std::min(bucket, heatmapGapBuckets - 1));
+}
+
+static void Accumulate(const AnalyticsBlock& block, BuildStats& stats)
+{
+    stats.events += block.Size();
+    for (size_t i = 0; i < block.Size(); i++) {
+        RunStats& run = stats.runs[RunKey(block.sessionId, block.run[i])];
+        run.legacy = block.version < 3;
+        uint8_t player = block.player[i];
+        if (player >= run.flaps.size()) {
+            run.flaps.resize(player + 1, 0);
+            run.down.resize(player + 1, false);
+        }
+        switch (block.type[i]) {
+        case ANALYTICS_FLAP:
+            run.flaps[player]++;
+            break;
+        case ANALYTICS_PAUSE:
+            run.pauses++;
+            break;
+        case ANALYTICS_DEATH:
+            // Every cat dies once; the run's length and score are taken from
+            // all of its deaths once every file is read
+            if (run.down[player]) break;
+            run.down[player] = true;
+            run.died = true;
+            run.lastDeathTick = std::max(run.lastDeathTick, block.tick[i]);
+            run.bestScore = std::max(run.bestScore, block.score[i]);
+            stats.runFlaps.push_back(run.flaps[player]);
+            stats.deathPipe.push_back(block.score[i]);
+            stats.deathGapDelta.push_back(block.gapDelta[i] / analyticsFixedScale);
+            stats.deathSpeed.push_back(block.pipeSpeed[i] / analyticsFixedScale);
+            break;
+        case ANALYTICS_RUN_END:
+            run.ended = true;
+            run.endTick = block.tick[i];
+            run.endScore = block.score[i];
+            run.outcome = block.outcome[i];
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+static void FinishRuns(BuildStats& stats)
+{
+    for (const auto& entry : stats.runs) {
+        const RunStats& run = entry.second;
+        if (run.ended) {
+            stats.runTicks.push_back(run.endTick);
+            stats.runScores.push_back(run.endScore);
+            if (run.outcome == ANALYTICS_OUTCOME_COURSE_COMPLETE) stats.coursesCompleted++;
+            // Cats that cleared the course never died; count their flaps here
+            for (size_t player = 0; player < run.flaps.size(); player++) {
+                if (!run.down[player]) stats.runFlaps.push_back(run.flaps[player]);
+            }
+        } else if (run.legacy && run.died) {
+            stats.runTicks.push_back(run.lastDeathTick);
+            stats.runScores.push_back(run.bestScore);
+        }
+    }
+}
+
+static void PrintPercentiles(const char* label, std::vector<uint32_t> values)
+{
+    printf("  %-12s p10 %8u  p50 %8u  p90 %8u  p99 %8u  max %8u\n", label,
+        Percentile(values, 0.10), Percentile(values, 0.50), Percentile(values, 0.90),
+        Percentile(values, 0.99), Percentile(values, 1.0));
+}
+
+static void PrintReport(const std::string& buildId, BuildStats& stats, bool csv)
+{
+    size_t finished = stats.runTicks.size();
+    size_t deaths = stats.deathPipe.size();
+    std::vector<uint32_t> scores(stats.runScores.begin(), stats.runScores.end());
+
+    if (csv) {
+        std::vector<uint32_t> ticks = stats.runTicks;
+        printf("%s,%zu,%llu,%u,%u,%u,%u,%zu\n", buildId.c_str(), finished, (unsigned long long)stats.events,
+            Percentile(ticks, 0.5), Percentile(ticks, 0.9), Percentile(scores, 0.5), Percentile(scores, 0.9),
+            stats.coursesCompleted);
+        return;
+    }
+
+    printf("Build %s: %zu runs finished (%zu completed a course), %zu runs seen, %llu events\n", buildId.c_str(),
+        finished, stats.coursesCompleted, stats.runs.size(), (unsigned long long)stats.events);
+    if (finished == 0) return;
+
+    PrintPercentiles("run ticks", stats.runTicks);
+    PrintPercentiles("score", scores);
+    PrintPercentiles("flaps", stats.runFlaps);
+
+    // Death heatmap: rows are the pipe the player was heading for, columns the
+    // player's offset from that pipe's gap center (negative = above)
+    int heatmap[heatmapPipeBuckets][heatmapGapBuckets] = {};
+    int maxCell = 1;
+    for (size_t i = 0; i < deaths; i++) {
+        int& cell = heatmap[PipeBucket(stats.deathPipe[i])][GapBucket(stats.deathGapDelta[i])];
+        cell++;
+        maxCell = std::max(maxCell, cell);
+    }
+    const char* shades = " .:-=+*#%@";
+    printf("  deaths by pipe (rows) vs gap delta (cols, %.0f..%.0f step %.0f)\n",
+        heatmapGapMin, heatmapGapMin + heatmapGapStep * heatmapGapBuckets, heatmapGapStep);
+    for (int row = 0; row < heatmapPipeBuckets; row++) {
+        int total = 0;
+        printf("  %-7s |", PipeBucketLabel(row).c_str());
+        for (int col = 0; col < heatmapGapBuckets; col++) {
+            int cell = heatmap[row][col];
+            total += cell;
+            printf("%c", shades[(cell * 9 + maxCell - 1) / maxCell]);
+        }
+        printf("| %d\n", total);
+    }
+
+    std::map<int, int> bySpeed;
+    for (float speed : stats.deathSpeed) {
+        bySpeed[(int)(speed / speedBucketSize)]++;
+    }
+    printf("  deaths by pipe speed\n");
+    for (const auto& bucket : bySpeed) {
+        printf("  %5.0f-%-5.0f %8d (%.1f%%)\n", bucket.first * speedBucketSize,
+            (bucket.first + 1) * speedBucketSize, bucket.second, 100.0 * bucket.second / deaths);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool csv = false;
+    std::vector<const char*> files;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) csv = true;
+        else files.push_back(argv[i]);
+    }
+    if (files.empty()) {
+        fprintf(stderr, "Usage: %s [--csv] <analytics.bin>...\n", argv[0]);
+        return 1;
+    }
+
+    std::map<std::string, BuildStats> builds;
+    AnalyticsBlock block;
+    for (const char* path : files) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) {
+            fprintf(stderr, "Cannot open %s\n", path);
+            return 1;
+        }
+        while (in.peek() != EOF) {
+            if (!ReadAnalyticsBlock(in, block)) {
+                fprintf(stderr, "%s: corrupt block, skipping rest of file\n", path);
+                break;
+            }
+            Accumulate(block, builds[block.buildId]);
+        }
+    }
+
+    if (csv) printf("build,runs,events,ticks_p50,ticks_p90,score_p50,score_p90,courses_completed\n");
+    for (auto& build : builds) {
+        FinishRuns(build.second);
+        PrintReport(build.first, build.second, csv);
+    }
+    return 0;
+}
@@ -0,0 +1,137 @@
+// Converts a text course description into the binary .hcc format read by the
+// game with --course.
+//
+// Usage: course_convert <input.txt> <output.hcc>
+//
+// Text format, one directive per line, '#' starts a comment:
+//   start <distance>           Distance of the first pipe (default 960, the right screen edge)
+//   spacing <distance>         Distance between consecutive pipes (default 600)
+//   gap <pixels>               Gap height for following pipes (default 230)
+//   width <pixels>             Pipe width for following pipes (default 80)
+//   speed <pixels/s>           Speed zone: pipe speed once the next pipe is passed
+//   pipe <center> [gap] [width]
+//                              One pipe with its gap centered at <center>;
+//                              gap and width override the current ones
+//   random <count> <maxDelta> [seed]
+//                              <count> pipes whose gap center moves at most
+//                              <maxDelta> from the previous one; seed is
+//                              nonzero, default 1
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+#include "../src/course.h"
+
+const float courseScreenHeight = 540.0f;  // Mirrors gameScreenHeight
+
+int main(int argc, char** argv)
+{
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <input.txt> <output.hcc>\n", argv[0]);
+        return 1;
+    }
+
+    std::ifstream in(argv[1]);
+    if (!in.is_open()) {
+        fprintf(stderr, "Cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    double distance = 960.0;
+    double spacing = 600.0;
+    float gap = 230.0f;
+    float width = 80.0f;
+    float pendingSpeed = 0.0f;
+    float lastCenter = courseScreenHeight / 2;
+    bool started = false;
+    std::vector<CourseEntry> pipes;
+
+    auto addPipe = [&](float center, float pipeGap, float pipeWidth) {
+        if (started) distance += spacing;
+        started = true;
+        center = std::max(pipeGap / 2, std::min(courseScreenHeight - pipeGap / 2, center));
+        CourseEntry entry;
+        entry.distance = distance;
+        entry.pipe = { 0.0f, center, pipeGap, pipeWidth, pendingSpeed };
+        pipes.push_back(entry);
+        pendingSpeed = 0.0f;
+        lastCenter = center;
+    };
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+        std::istringstream words(line);
+        std::string directive;
+        if (!(words >> directive)) continue;
+
+        bool ok = true;
+        if (directive == "start") {
+            ok = (bool)(words >> distance);
+        } else if (directive == "spacing") {
+            ok = (bool)(words >> spacing) && spacing > 0;
+        } else if (directive == "gap") {
+            ok = (bool)(words >> gap) && gap > 0;
+        } else if (directive == "width") {
+            ok = (bool)(words >> width) && width > 0;
+        } else if (directive == "speed") {
+            ok = (bool)(words >> pendingSpeed) && pendingSpeed > 0;
+        } else if (directive == "pipe") {
+            float center;
+            float pipeGap = gap;
+            float pipeWidth = width;
+            ok = (bool)(words >> center);
+            // Optional fields must parse when present; 'pipe 270 abc' is an error
+            if (ok && !(words >> std::ws).eof()) ok = (bool)(words >> pipeGap) && pipeGap > 0;
+            if (ok && !(words >> std::ws).eof()) ok = (bool)(words >> pipeWidth) && pipeWidth > 0;
+            if (ok) addPipe(center, pipeGap, pipeWidth);
+        } else if (directive == "random") {
+            long long count;
+            float maxDelta;
+            uint32_t seed = 1;
+            ok = (bool)(words >> count >> maxDelta) && count > 0;
+            // xorshift32 never leaves 0, so a zero seed would make a flat course.
+            // Read wide so a negative seed fails instead of wrapping.
+            if (ok && !(words >> std::ws).eof()) {
+                long long seedValue;
+                ok = (bool)(words >> seedValue) && seedValue > 0 && seedValue <= UINT32_MAX;
+                seed = (uint32_t)seedValue;
+            }
+            for (long long i = 0; ok && i < count; i++) {
+                // xorshift32, seeded per directive so courses are reproducible
+                seed ^= seed << 13;
+                seed ^= seed >> 17;
+                seed ^= seed << 5;
+                float t = (seed >> 8) * (1.0f / 16777216.0f);
+                addPipe(lastCenter + (t * 2.0f - 1.0f) * maxDelta, gap, width);
+            }
+        } else {
+            ok = false;
+        }
+        // Anything left over is a field the directive does not take
+        if (ok && !(words >> std::ws).eof()) ok = false;
+
+        if (!ok) {
+            fprintf(stderr, "%s:%d: cannot parse '%s'\n", argv[1], lineNumber, line.c_str());
+            return 1;
+        }
+    }
+
+    if (pipes.empty()) {
+        fprintf(stderr, "%s: course has no pipes\n", argv[1]);
+        return 1;
+    }
+    if (!WriteCourse(argv[2], pipes)) {
+        fprintf(stderr, "Cannot write %s\n", argv[2]);
+        return 1;
+    }
+    printf("Wrote %zu pipes to %s\n", pipes.size(), argv[2]);
+    return 0;
+}
@@ -0,0 +1,381 @@
+// Sweeps DifficultyParams over a grid and simulates bot populations on each
+// configuration, reporting survival curves and how close the median run
+// length comes to a target.
+//
+// Usage: difficulty_tuner [options]
+//   --target <seconds>        Target median run length (default 30)
+//   --runs <n>                Runs per bot skill per configuration (default 200)
+//   --threads <n>             Worker threads (default: hardware concurrency)
+//   --top <n>                 Configurations to print (default 10)
+//   --csv <file>              Also write every configuration to a CSV file
+//   --gravity a,b,c           Grid values, one option per DifficultyParams field:
+//   --jump-force, --pipe-gap, --max-gap-diff, --speed-increase, --max-speed, --scale-with-speed 0,1
+// Fields without a grid option keep their default.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+
+#include "../src/difficulty.h"
+
+// Mirrors the fixed layout in Game (960x540 game screen, 144 Hz target)
+const float screenWidth = 960.0f;
+const float screenHeight = 540.0f;
+const float playerX = screenWidth / 4;
+const float playerSize = 80.0f;
+const float collisionBoxWidth = playerSize * 0.70f;
+const float collisionBoxHeight = playerSize * 0.55f;
+const float pipeWidth = 80.0f;
+const float basePipeSpeed = 300.0f;
+const float initialPipeDistance = 600.0f;
+const float timeStep = 1.0f / 144.0f;
+const float maxRunSeconds = 600.0f;
+
+// Survival curve sample points in seconds
+const float survivalTimes[] = { 5, 10, 20, 30, 60, 120, 300 };
+const int survivalPoints = sizeof(survivalTimes) / sizeof(survivalTimes[0]);
+
+struct BotSkill {
+    const char* name;
+    float reactionDelay;  // Seconds between the world changing and the bot seeing it
+    float timingJitter;   // Standard deviation of extra delay before each flap
+    float aimError;       // Standard deviation of the bot's target height, per pipe
+};
+
+const BotSkill botSkills[] = {
+    { "novice", 0.25f, 0.060f, 30.0f },
+    { "casual", 0.18f, 0.035f, 18.0f },
+    { "expert", 0.12f, 0.015f, 8.0f },
+};
+const int botSkillCount = sizeof(botSkills) / sizeof(botSkills[0]);
+
+struct Random {
+    uint64_t state;
+    explicit Random(uint64_t seed) : state(seed * 0x9E3779B97F4A7C15ull + 1) {}
+    uint32_t Next()
+    {
+        // splitmix64
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return (uint32_t)((z ^ (z >> 31)) >> 32);
+    }
+    float Uniform() { return (Next() >> 8) * (1.0f / 16777216.0f); }
+    float Gaussian()
+    {
+        float u1 = std::max(Uniform(), 1e-7f);
+        float u2 = Uniform();
+        return sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+    }
+};
+
+// Seeds one random stream of a run; the stream number keeps the course,
+// aim and timing draws independent of each other
+static uint64_t StreamSeed(int stream, int skill, int run)
+{
+    return ((uint64_t)stream << 48) | ((uint64_t)skill << 32) | (uint32_t)run;
+}
+
+// The course of one run: a uniform draw per pipe, placed in whatever gap
+// range the configuration allows when the pipe spawns
+static std::vector<float> GenerateCourse(int run, int pipeCount)
+{
+    Random rng(StreamSeed(0, 0, run));
+    std::vector<float> course(pipeCount);
+    for (float& draw : course) draw = rng.Uniform();
+    return course;
+}
+
+struct SimPipe {
+    float x;
+    float gapCenter;
+    float aimOffset;
+    bool scored;
+};
+
+// One run with the same update order as Game::Update. Returns seconds survived.
+// Pipe n takes course[n] and the nth aim draw, flap n the nth timing draw.
+static float SimulateRun(const DifficultyParams& params, const BotSkill& skill,
+                         const std::vector<float>& course, Random& aim, Random& timing)
+{
+    float playerY = screenHeight / 2;
+    float velocity = 0.0f;
+    float pipeSpeed = basePipeSpeed;
+    float gravity = params.gravity;
+    float jumpForce = params.jumpForce;
+    float pipeSpawnTimer = 0.0f;
+    float pipeSpawnInterval = 2.0f;
+    std::vector<SimPipe> pipes;
+    pipes.reserve(8);
+    size_t pipesSpawned = 0;
+
+    // The bot acts on what it saw reactionDelay ago
+    int delayTicks = std::max(1, (int)lroundf(skill.reactionDelay / timeStep));
+    std::vector<float> seenY(delayTicks, playerY);
+    std::vector<float> seenVelocity(delayTicks, velocity);
+    int scheduledFlap = -1;
+    int lastFlap = -1000;
+    const int flapCooldown = (int)(0.12f / timeStep);
+
+    int maxTicks = (int)(maxRunSeconds / timeStep);
+    for (int tick = 0; tick < maxTicks; tick++) {
+        // Bot decision
+        int slot = tick % delayTicks;
+        float observedY = seenY[slot];
+        float observedVelocity = seenVelocity[slot];
+        seenY[slot] = playerY;
+        seenVelocity[slot] = velocity;
+
+        float targetY = screenHeight / 2;
+        for (const auto& pipe : pipes) {
+            if (pipe.x + pipeWidth > playerX - collisionBoxWidth/2) {
+                targetY = pipe.gapCenter + params.pipeGap * 0.15f + pipe.aimOffset;
+                break;
+            }
+        }
+        // Extrapolate the stale observation to now, as a player would
+        float predictedY = observedY + observedVelocity * skill.reactionDelay + 0.5f * gravity * skill.reactionDelay * skill.reactionDelay;
+        if (scheduledFlap < 0 && predictedY > targetY && tick - lastFlap >= flapCooldown) {
+            scheduledFlap = tick + (int)(fabsf(timing.Gaussian()) * skill.timingJitter / timeStep);
+        }
+        if (scheduledFlap >= 0 && tick >= scheduledFlap) {
+            velocity = jumpForce;
+            lastFlap = tick;
+            scheduledFlap = -1;
+        }
+
+        // Game::UpdatePipeSpeed
+        pipeSpeed = std::min(pipeSpeed + params.pipeSpeedIncrease * timeStep, params.maxSpeed);
+        pipeSpawnInterval = initialPipeDistance / pipeSpeed;
+        if (params.scalePhysicsWithSpeed) {
+            float speedRatio = pipeSpeed / basePipeSpeed;
+            gravity = params.gravity * speedRatio;
+            jumpForce = params.jumpForce * speedRatio;
+        }
+
+        velocity += gravity * timeStep;
+        playerY += velocity * timeStep;
+        if (playerY - collisionBoxHeight/2 < 0 || playerY + collisionBoxHeight/2 > screenHeight) {
+            return tick * timeStep;
+        }
+
+        pipeSpawnTimer += timeStep;
+        if (pipeSpawnTimer >= pipeSpawnInterval) {
+            pipeSpawnTimer = 0.0f;
+            float gapCenter = screenHeight / 2;
+            if (!pipes.empty()) {
+                float previous = pipes.back().gapCenter;
+                float minGap = std::max(params.pipeGap/2, previous - params.maxGapHeightDifference);
+                float maxGap = std::min(screenHeight - params.pipeGap/2, previous + params.maxGapHeightDifference);
+                int span = (int)maxGap - (int)minGap + 1;
+                gapCenter = (float)((int)minGap + (int)(course[pipesSpawned] * span));
+            }
+            pipes.push_back({ screenWidth, gapCenter, aim.Gaussian() * skill.aimError, false });
+            pipesSpawned++;
+        }
+
+        for (auto& pipe : pipes) {
+            pipe.x -= pipeSpeed * timeStep;
+            if (playerX + collisionBoxWidth/2 > pipe.x && playerX - collisionBoxWidth/2 < pipe.x + pipeWidth) {
+                if (playerY - collisionBoxHeight/2 < pipe.gapCenter - params.pipeGap/2 ||
+                    playerY + collisionBoxHeight/2 > pipe.gapCenter + params.pipeGap/2) {
+                    return tick * timeStep;
+                }
+            }
+        }
+        pipes.erase(std::remove_if(pipes.begin(), pipes.end(),
+            [](const SimPipe& pipe) { return pipe.x < -pipeWidth; }), pipes.end());
+    }
+    return maxRunSeconds;
+}
+
+struct ConfigResult {
+    DifficultyParams params;
+    float median[botSkillCount];
+    float survival[botSkillCount][survivalPoints];
+    float overallMedian;
+};
+
+static float Median(std::vector<float>& values)
+{
+    std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    return values[values.size() / 2];
+}
+
+// Common random numbers: run n flies the course generated from n alone, and
+// its aim and timing noise come from separate streams seeded by skill and n.
+// Every configuration therefore sees the same pipe draws and the same aim
+// error per pipe, whatever it does to the number of flaps.
+static void Evaluate(ConfigResult& result, int runs)
+{
+    // Pipes spawn at most once per initialPipeDistance at top speed
+    float topSpeed = std::max(basePipeSpeed, result.params.maxSpeed);
+    int pipeCount = (int)(maxRunSeconds * topSpeed / initialPipeDistance) + 2;
+    std::vector<std::vector<float>> courses(runs);
+    for (int r = 0; r < runs; r++) courses[r] = GenerateCourse(r, pipeCount);
+
+    std::vector<float> all;
+    all.reserve(runs * botSkillCount);
+    std::vector<float> lengths(runs);
+    for (int s = 0; s < botSkillCount; s++) {
+        for (int r = 0; r < runs; r++) {
+            Random aim(StreamSeed(1, s, r));
+            Random timing(StreamSeed(2, s, r));
+            lengths[r] = SimulateRun(result.params, botSkills[s], courses[r], aim, timing);
+        }
+        for (int p = 0; p < survivalPoints; p++) {
+            int alive = (int)std::count_if(lengths.begin(), lengths.end(),
+                [p](float length) { return length >= survivalTimes[p]; });
+            result.survival[s][p] = (float)alive / runs;
+        }
+        all.insert(all.end(), lengths.begin(), lengths.end());
+        result.median[s] = Median(lengths);
+    }
+    result.overallMedian = Median(all);
+}
+
+static std::vector<float> ParseList(const char* text)
+{
+    std::vector<float> values;
+    const char* start = text;
+    char* end;
+    while (*start) {
+        values.push_back(strtof(start, &end));
+        if (end == start) break;
+        start = (*end == ',') ? end + 1 : end;
+    }
+    return values;
+}
+
+int main(int argc, char** argv)
+{
+    DifficultyParams defaults;
+    std::vector<float> gravity = { defaults.gravity };
+    std::vector<float> jumpForce = { defaults.jumpForce };
+    std::vector<float> pipeGap = { defaults.pipeGap };
+    std::vector<float> maxGapDiff = { defaults.maxGapHeightDifference };
+    std::vector<float> speedIncrease = { defaults.pipeSpeedIncrease };
+    std::vector<float> maxSpeed = { defaults.maxSpeed };
+    std::vector<float> scaleWithSpeed = { defaults.scalePhysicsWithSpeed ? 1.0f : 0.0f };
+    float target = 30.0f;
+    int runs = 200;
+    int threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    int top = 10;
+    const char* csvPath = nullptr;
+
+    for (int i = 1; i < argc; i += 2) {
+        const char* option = argv[i];
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Option %s needs a value\n", option);
+            return 1;
+        }
+        const char* value = argv[i + 1];
+        if (strcmp(option, "--target") == 0) target = strtof(value, nullptr);
+        else if (strcmp(option, "--runs") == 0) runs = std::max(1, atoi(value));
+        else if (strcmp(option, "--threads") == 0) threads = std::max(1, atoi(value));
+        else if (strcmp(option, "--top") == 0) top = atoi(value);
+        else if (strcmp(option, "--csv") == 0) csvPath = value;
+        else if (strcmp(option, "--gravity") == 0) gravity = ParseList(value);
+        else if (strcmp(option, "--jump-force") == 0) jumpForce = ParseList(value);
+        else if (strcmp(option, "--pipe-gap") == 0) pipeGap = ParseList(value);
+        else if (strcmp(option, "--max-gap-diff") == 0) maxGapDiff = ParseList(value);
+        else if (strcmp(option, "--speed-increase") == 0) speedIncrease = ParseList(value);
+        else if (strcmp(option, "--max-speed") == 0) maxSpeed = ParseList(value);
+        else if (strcmp(option, "--scale-with-speed") == 0) scaleWithSpeed = ParseList(value);
+        else {
+            fprintf(stderr, "Unknown option %s\n", option);
+            return 1;
+        }
+    }
+
+    std::vector<ConfigResult> results;
+    for (float g : gravity)
+    for (float j : jumpForce)
+    for (float gap : pipeGap)
+    for (float diff : maxGapDiff)
+    for (float inc : speedIncrease)
+    for (float speed : maxSpeed)
+    for (float scale : scaleWithSpeed) {
+        ConfigResult result = {};
+        result.params.gravity = g;
+        result.params.jumpForce = j;
+        result.params.pipeGap = gap;
+        result.params.maxGapHeightDifference = diff;
+        result.params.pipeSpeedIncrease = inc;
+        result.params.maxSpeed = speed;
+        result.params.scalePhysicsWithSpeed = scale != 0.0f;
+        results.push_back(result);
+    }
+
+    printf("Simulating %zu configurations x %d skills x %d runs on %d threads\n",
+        results.size(), botSkillCount, runs, threads);
+    auto start = std::chrono::steady_clock::now();
+
+    // Configurations are handed out one at a time so slow (long surviving)
+    // ones don't leave other threads idle
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&]() {
+            size_t index;
+            while ((index = next.fetch_add(1)) < results.size()) {
+                Evaluate(results[index], runs);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("Done in %.1f s\n\n", seconds);
+
+    if (csvPath) {
+        FILE* csv = fopen(csvPath, "w");
+        if (!csv) {
+            fprintf(stderr, "Cannot write %s\n", csvPath);
+            return 1;
+        }
+        fprintf(csv, "gravity,jump_force,pipe_gap,max_gap_diff,speed_increase,max_speed,scale_with_speed,median");
+        for (int s = 0; s < botSkillCount; s++) fprintf(csv, ",median_%s", botSkills[s].name);
+        fprintf(csv, "\n");
+        for (const auto& result : results) {
+            const DifficultyParams& p = result.params;
+            fprintf(csv, "%g,%g,%g,%g,%g,%g,%d,%.2f", p.gravity, p.jumpForce, p.pipeGap, p.maxGapHeightDifference,
+                p.pipeSpeedIncrease, p.maxSpeed, p.scalePhysicsWithSpeed ? 1 : 0, result.overallMedian);
+            for (int s = 0; s < botSkillCount; s++) fprintf(csv, ",%.2f", result.median[s]);
+            fprintf(csv, "\n");
+        }
+        fclose(csv);
+    }
+
+    std::sort(results.begin(), results.end(), [target](const ConfigResult& a, const ConfigResult& b) {
+        return fabsf(a.overallMedian - target) < fabsf(b.overallMedian - target);
+    });
+
+    printf("Closest to a %.0f s median run:\n", target);
+    for (int i = 0; i < std::min(top, (int)results.size()); i++) {
+        const ConfigResult& result = results[i];
+        const DifficultyParams& p = result.params;
+        printf("#%d median %.1f s  { gravity %g, jumpForce %g, pipeGap %g, maxGapHeightDifference %g, pipeSpeedIncrease %g, maxSpeed %g, scalePhysicsWithSpeed %s }\n",
+            i + 1, result.overallMedian, p.gravity, p.jumpForce, p.pipeGap, p.maxGapHeightDifference,
+            p.pipeSpeedIncrease, p.maxSpeed, p.scalePhysicsWithSpeed ? "true" : "false");
+        printf("    survival at");
+        for (int t = 0; t < survivalPoints; t++) printf(" %5.0fs", survivalTimes[t]);
+        printf("   median\n");
+        for (int s = 0; s < botSkillCount; s++) {
+            printf("    %-11s", botSkills[s].name);
+            for (int t = 0; t < survivalPoints; t++) printf(" %5.0f%%", result.survival[s][t] * 100.0f);
+            printf("  %6.1f s\n", result.median[s]);
+        }
+    }
+    return 0;
+}